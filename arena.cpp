@@ -0,0 +1,97 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include <sys/mman.h>
+
+namespace json {
+
+namespace {
+
+constexpr size_t hugePageSize = size_t(1) << 21;
+
+size_t roundUp(size_t size, size_t to) {
+    return (size + to - 1) / to * to;
+}
+
+// Maps `size` bytes, a multiple of hugePageSize, preferably on huge pages.
+// Returns nullptr if even ordinary pages cannot be mapped.
+std::byte* mapHuge(size_t size, Arena::Pages& pages) {
+#ifdef MAP_HUGETLB
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+        pages = Arena::Pages::Explicit;
+        return static_cast<std::byte*>(p);
+    }
+#endif
+    // Over-map so the block can start on a huge page boundary, which
+    // transparent huge pages need, and unmap the slack on either side.
+    void* raw = mmap(nullptr, size + hugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+    auto start = reinterpret_cast<uintptr_t>(raw);
+    auto aligned = roundUp(start, hugePageSize);
+    if (aligned > start) munmap(raw, aligned - start);
+    size_t tail = start + hugePageSize - aligned;
+    if (tail) munmap(reinterpret_cast<void*>(aligned + size), tail);
+    pages = Arena::Pages::Normal;
+#ifdef MADV_HUGEPAGE
+    if (madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE) == 0) pages = Arena::Pages::Transparent;
+#endif
+    return reinterpret_cast<std::byte*>(aligned);
+}
+
+}
+
+Arena::Arena() : Arena(Options{}) { }
+
+Arena::Arena(Options options) : options(options) { }
+
+Arena::Arena(std::span<std::byte> initial) : Arena(initial, Options{}) { }
+
+Arena::Arena(std::span<std::byte> initial, Options options)
+    : options(options), next(initial.data()), end(initial.data() + initial.size()) { }
+
+Arena::~Arena() {
+    for (auto& block : blocks) {
+        if (options.hugePages) munmap(block.data, block.size);
+        else std::free(block.data);
+    }
+}
+
+void Arena::grow(size_t size, size_t alignment) {
+    size_t needed = std::max(options.blockSize, size + alignment);
+    blocks.reserve(blocks.size() + 1);
+    Block block{nullptr, needed, Pages::Normal};
+    if (options.hugePages) {
+        block.size = roundUp(needed, hugePageSize);
+        block.data = mapHuge(block.size, block.pages);
+    } else {
+        block.data = static_cast<std::byte*>(std::malloc(block.size));
+    }
+    if (!block.data) throw std::bad_alloc();
+    blocks.push_back(block);
+    ++counts[static_cast<size_t>(block.pages)];
+    next = block.data;
+    end = block.data + block.size;
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    auto at = roundUp(reinterpret_cast<uintptr_t>(next), alignment);
+    if (!next || at + size > reinterpret_cast<uintptr_t>(end)) {
+        grow(size, alignment);
+        at = roundUp(reinterpret_cast<uintptr_t>(next), alignment);
+    }
+    next = reinterpret_cast<std::byte*>(at + size);
+    return reinterpret_cast<void*>(at);
+}
+
+size_t Arena::capacity() const {
+    size_t total = 0;
+    for (auto& block : blocks) total += block.size;
+    return total;
+}
+
+};
@@ -0,0 +1,97 @@
+#ifndef JSON_ARENA_HPP
+#define JSON_ARENA_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace json {
+
+// Bump allocator for the nodes of a document. Memory is carved from large
+// blocks and only returned when the arena is destroyed, so a node that is
+// replaced keeps its space until then. Not thread-safe: fill it from one
+// thread at a time. It can start from a caller's buffer, e.g. on the stack,
+// and only take blocks from the system once that is full.
+class Arena {
+public:
+    // What backs a block.
+    enum class Pages {
+        // malloc, or mmap when huge pages were asked for but not granted.
+        Normal,
+        // Transparent huge pages requested with madvise(MADV_HUGEPAGE).
+        Transparent,
+        // Pages from the reserved pool, mapped with MAP_HUGETLB.
+        Explicit
+    };
+    struct Options {
+        // Size of each block; bigger requests get a block of their own.
+        size_t blockSize = size_t(1) << 20;
+        // Back blocks with 2 MiB pages, rounding them up to whole pages:
+        // explicit pages when the system has some reserved, else transparent
+        // ones, else ordinary pages.
+        bool hugePages = false;
+    };
+private:
+    struct Block {
+        std::byte* data;
+        size_t size;
+        Pages pages;
+    };
+    Options options;
+    std::vector<Block> blocks;
+    std::byte* next = nullptr;
+    std::byte* end = nullptr;
+    std::array<size_t, 3> counts{};
+
+    void grow(size_t size, size_t alignment);
+public:
+    Arena();
+    explicit Arena(Options options);
+    // `initial` is used first and must outlive the arena.
+    explicit Arena(std::span<std::byte> initial);
+    Arena(std::span<std::byte> initial, Options options);
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t alignment);
+    // Bytes of all blocks held.
+    size_t capacity() const;
+    // Number of blocks with this backing; the initial buffer is not one.
+    size_t blocksWith(Pages pages) const { return counts[static_cast<size_t>(pages)]; }
+};
+
+// Places nodes and their containers' storage in an arena, e.g. with
+// std::allocate_shared. Every copy shares ownership of the arena, so it lives
+// as long as anything in it. Without an arena it uses the heap.
+template <typename T>
+class ArenaAllocator {
+private:
+    template <typename U>
+    friend class ArenaAllocator;
+    std::shared_ptr<Arena> arena;
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    ArenaAllocator() = default;
+    explicit ArenaAllocator(std::shared_ptr<Arena> arena) : arena(std::move(arena)) { }
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) { }
+    T* allocate(size_t n) {
+        if (!arena) return std::allocator<T>().allocate(n);
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+        if (!arena) std::allocator<T>().deallocate(p, n);
+    }
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+};
+
+};
+
+#endif
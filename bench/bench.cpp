@@ -0,0 +1,188 @@
+#include "json.hpp"
+#include "simd.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters are read through perf_event_open when the kernel allows
+// it (see /proc/sys/kernel/perf_event_paranoid). Pass --no-perf to skip them.
+class PerfCounters {
+public:
+    struct Event {
+        const char* name;
+        uint32_t type;
+        uint64_t config;
+    };
+private:
+    std::vector<Event> events;
+    std::vector<int> fds;
+    std::vector<uint64_t> values;
+public:
+    PerfCounters(bool enabled) {
+#ifdef __linux__
+        constexpr uint64_t l1Miss = PERF_COUNT_HW_CACHE_L1D
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        events = {
+            {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {"L1d-misses", PERF_TYPE_HW_CACHE, l1Miss},
+            {"LLC-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        };
+        if (!enabled) events.clear();
+        for (auto& event : events) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = event.type;
+            attr.config = event.config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds.push_back(static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0)));
+        }
+#else
+        (void)enabled;
+#endif
+        values.assign(events.size(), 0);
+    }
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd : fds) if (fd >= 0) close(fd);
+#endif
+    }
+    bool available() const {
+        for (int fd : fds) if (fd >= 0) return true;
+        return false;
+    }
+    void start() {
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    void stop() {
+#ifdef __linux__
+        for (size_t i = 0; i < fds.size(); ++i) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fds[i], &values[i], sizeof(uint64_t)) != sizeof(uint64_t)) values[i] = 0;
+        }
+#endif
+    }
+    const std::vector<Event>& names() const { return events; }
+    // Negative when the counter could not be opened.
+    double value(size_t i) const { return fds[i] < 0 ? -1 : static_cast<double>(values[i]); }
+};
+
+struct Case {
+    std::string name;
+    size_t bytes;
+    size_t nodes;
+    size_t iterations;
+    std::function<void()> run;
+};
+
+static std::string writeTemp(const std::string& name, const std::string& contents) {
+    std::string path = "/tmp/cpp-json-bench-" + name + ".json";
+    std::ofstream(path) << contents;
+    return path;
+}
+
+// A list of `count` flat records; returns the document and its node count.
+static std::pair<std::string, size_t> records(size_t count) {
+    std::ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < count; ++i) {
+        os << (i ? "," : "")
+           << "{\"id\": " << i
+           << ", \"name\": \"user" << i << "\""
+           << ", \"score\": " << i % 100 << "." << i % 7
+           << ", \"active\": " << (i % 2 ? "true" : "false")
+           << ", \"tags\": [\"a\", \"b\", \"c\"]}";
+    }
+    os << "]";
+    return {os.str(), 1 + count * 9};
+}
+
+static void report(const Case& c, PerfCounters& perf) {
+    auto start = std::chrono::steady_clock::now();
+    perf.start();
+    for (size_t i = 0; i < c.iterations; ++i) c.run();
+    perf.stop();
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    double bytes = static_cast<double>(c.bytes * c.iterations);
+    double nodes = static_cast<double>(c.nodes * c.iterations);
+    std::cout << std::left << std::setw(16) << c.name
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << elapsed / c.iterations / 1000 << " us/iter";
+    if (bytes > 0) std::cout << std::setw(10) << bytes / elapsed * 1e3 << " MB/s";
+    std::cout << "\n";
+
+    // Cases that read no input (lookups) only report per-node figures.
+    auto row = [&](const char* name, double total) {
+        std::cout << std::setw(16) << "" << std::setw(14) << name;
+        if (bytes > 0) std::cout << std::setw(12) << total / bytes << "/B";
+        std::cout << std::setw(12) << total / nodes << "/node\n";
+    };
+    row("ns", elapsed);
+    for (size_t i = 0; i < perf.names().size(); ++i) {
+        if (perf.value(i) >= 0) row(perf.names()[i].name, perf.value(i));
+    }
+}
+
+int main(int argc, char** argv) {
+    bool usePerf = !(argc > 1 && std::string(argv[1]) == "--no-perf");
+    PerfCounters perf(usePerf);
+    if (usePerf && !perf.available())
+        std::cout << "perf_event_open unavailable, reporting wall time only.\n";
+    // Set JSON_ISA to compare kernel implementations.
+    std::cout << "kernels: " << json::isaName(json::activeIsa()) << "\n";
+
+    auto [small, smallNodes] = records(1);
+    auto [large, largeNodes] = records(20000);
+    std::string smallPath = writeTemp("small", small);
+    std::string largePath = writeTemp("large", large);
+    json::Json document = json::fromFile(largePath);
+
+    std::vector<Case> cases = {
+        {"parse/small", small.size(), smallNodes, 20000, [&] { json::fromFile(smallPath); }},
+        {"parse/inline", small.size(), smallNodes, 20000, [&] { json::SmallDocument<> message(small); }},
+        {"parse/large", large.size(), largeNodes, 5, [&] { json::fromFile(largePath); }},
+        {"parse/arena", large.size(), largeNodes, 5, [&] {
+            auto arena = std::make_shared<json::Arena>(json::Arena::Options{.hugePages = true});
+            json::fromFile(largePath, json::ParseOptions{.arena = arena});
+        }},
+        {"lookup/large", 0, 20000 * 2, 5, [&] {
+            for (size_t i = 0; i < 20000; ++i) document[i]["name"];
+        }},
+        {"dump/large", large.size(), largeNodes, 5, [&] {
+            std::ostringstream os;
+            os << document;
+        }},
+    };
+    for (auto& c : cases) report(c, perf);
+
+    std::remove(smallPath.c_str());
+    std::remove(largePath.c_str());
+    return 0;
+}
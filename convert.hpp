@@ -0,0 +1,282 @@
+#ifndef JSON_CONVERT_HPP
+#define JSON_CONVERT_HPP
+
+#include "json.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace json {
+
+// Customisation point: specialise Convert<T> with
+//     static std::shared_ptr<Node> to(const T&);   (and optionally T&&)
+//     static T from(const Node&);
+// to make T usable with to_json and from_json. Integers and floating point
+// values are stored as the DOM's int and float when they fit, and as raw
+// numbers otherwise; reading one that does not fit T throws.
+template <typename T>
+struct Convert;
+
+template <typename T>
+Json to_json(T&& value) {
+    return Json(Convert<std::remove_cvref_t<T>>::to(std::forward<T>(value)));
+}
+
+template <typename T>
+T from_json(const Json& json) {
+    return Convert<T>::from(json.node());
+}
+
+template <typename T>
+T from_json(Json::View view) {
+    return Convert<T>::from(view.node());
+}
+
+namespace detail {
+
+// Moves the elements out of rvalue containers and copies them otherwise.
+template <typename Container, typename Element>
+decltype(auto) forwardElement(Element& element) {
+    if constexpr (std::is_lvalue_reference_v<Container>)
+        return static_cast<const Element&>(element);
+    else
+        return std::move(element);
+}
+
+template <typename Container, typename List>
+std::shared_ptr<Node> toList(List&& list) {
+    // By value type, so proxies such as std::vector<bool>'s convert too.
+    using Element = std::ranges::range_value_t<List>;
+    auto node = std::make_shared<ListNode>();
+    node->reserve(std::size(list));
+    for (auto&& element : list)
+        node->addChild(Convert<Element>::to(forwardElement<Container>(element)));
+    return node;
+}
+
+template <typename Container, typename Map>
+std::shared_ptr<Node> toObject(Map&& map) {
+    using Value = typename std::remove_cvref_t<Map>::mapped_type;
+    auto node = std::make_shared<ObjectNode>();
+    for (auto& [key, value] : map)
+        node->addOrEditChild(std::string(key), Convert<Value>::to(forwardElement<Container>(value)));
+    return node;
+}
+
+// Stores a number the DOM's int or float cannot hold as written.
+template <typename T>
+std::shared_ptr<Node> rawNumber(T value) {
+    char buffer[64];
+    auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    if (error != std::errc()) throw WrongObjectType::OutOfRange();
+    return std::make_shared<ValueNode<float>>(std::string(buffer, end));
+}
+
+inline const ListNode& asList(const Node& node) {
+    if (node.type() != ValueType::Concrete::List) throw WrongObjectType::NotList();
+    return static_cast<const ListNode&>(node);
+}
+
+inline const ObjectNode& asObject(const Node& node) {
+    if (node.type() != ValueType::Concrete::Object) throw WrongObjectType::NotObject();
+    return static_cast<const ObjectNode&>(node);
+}
+
+}
+
+template <is_json_leaf_type T>
+struct Convert<T> {
+    template <typename U>
+    static std::shared_ptr<Node> to(U&& value) { return std::make_shared<ValueNode<T>>(std::forward<U>(value)); }
+    static T from(const Node& node) { return checkedValue<T>(node); }
+};
+
+template <typename T>
+requires (std::integral<T> && !is_json_leaf_type<T>)
+struct Convert<T> {
+    static std::shared_ptr<Node> to(T value) {
+        if (std::in_range<int>(value)) return std::make_shared<ValueNode<int>>(static_cast<int>(value));
+        return detail::rawNumber(value);
+    }
+    static T from(const Node& node) {
+        // Integers beyond int are kept as raw float nodes; fractions are not integers.
+        if (node.type() == ValueType::Concrete::Float) {
+            double value = *numberValue<double>(node);
+            if (value != std::trunc(value)) throw WrongObjectType::NotLeaf<int>();
+        }
+        if (auto value = numberValue<T>(node)) return *value;
+        throw WrongObjectType::NotLeaf<int>();
+    }
+};
+
+template <typename T>
+requires (std::floating_point<T> && !is_json_leaf_type<T>)
+struct Convert<T> {
+    static std::shared_ptr<Node> to(T value) {
+        if (!std::isfinite(value) || static_cast<T>(static_cast<float>(value)) == value)
+            return std::make_shared<ValueNode<float>>(static_cast<float>(value));
+        return detail::rawNumber(value);
+    }
+    static T from(const Node& node) {
+        if (auto value = numberValue<T>(node)) return *value;
+        throw WrongObjectType::NotLeaf<float>();
+    }
+};
+
+template <>
+struct Convert<std::string_view> {
+    static std::shared_ptr<Node> to(std::string_view value) { return std::make_shared<ValueNode<std::string>>(std::string(value)); }
+    // Views the node's text, valid as long as the node is.
+    static std::string_view from(const Node& node) {
+        if (node.type() != ValueType::Concrete::String) throw WrongObjectType::NotLeaf<std::string>();
+        return static_cast<const ValueNode<std::string>&>(node).view();
+    }
+};
+
+template <>
+struct Convert<const char*> {
+    static std::shared_ptr<Node> to(const char* value) { return std::make_shared<ValueNode<std::string>>(value); }
+};
+
+template <typename T>
+struct Convert<std::vector<T>> {
+    template <typename U>
+    static std::shared_ptr<Node> to(U&& list) { return detail::toList<U>(list); }
+    static std::vector<T> from(const Node& node) {
+        auto& children = detail::asList(node).getChildren();
+        std::vector<T> list;
+        list.reserve(children.size());
+        for (auto& child : children) list.push_back(Convert<T>::from(*child));
+        return list;
+    }
+};
+
+template <typename T, size_t N>
+struct Convert<std::array<T, N>> {
+    template <typename U>
+    static std::shared_ptr<Node> to(U&& list) { return detail::toList<U>(list); }
+    static std::array<T, N> from(const Node& node) {
+        auto& children = detail::asList(node).getChildren();
+        if (children.size() != N) throw WrongObjectType("List does not have " + std::to_string(N) + " elements.");
+        std::array<T, N> list;
+        for (size_t i = 0; i < N; ++i) list[i] = Convert<T>::from(*children[i]);
+        return list;
+    }
+};
+
+// Spans are views, so they only convert to json.
+template <typename T, size_t N>
+struct Convert<std::span<T, N>> {
+    static std::shared_ptr<Node> to(std::span<T, N> list) { return detail::toList<std::span<T, N>&>(list); }
+};
+
+template <typename T>
+struct Convert<std::map<std::string, T>> {
+    template <typename U>
+    static std::shared_ptr<Node> to(U&& map) { return detail::toObject<U>(map); }
+    static std::map<std::string, T> from(const Node& node) {
+        std::map<std::string, T> map;
+        for (auto& [key, child] : detail::asObject(node).getChildren())
+            map.emplace_hint(map.end(), key, Convert<T>::from(*child));
+        return map;
+    }
+};
+
+template <typename T>
+struct Convert<std::unordered_map<std::string, T>> {
+    template <typename U>
+    static std::shared_ptr<Node> to(U&& map) { return detail::toObject<U>(map); }
+    static std::unordered_map<std::string, T> from(const Node& node) {
+        auto& children = detail::asObject(node).getChildren();
+        std::unordered_map<std::string, T> map;
+        map.reserve(children.size());
+        for (auto& [key, child] : children) map.emplace(key, Convert<T>::from(*child));
+        return map;
+    }
+};
+
+template <typename T>
+struct Convert<std::optional<T>> {
+    template <typename U>
+    static std::shared_ptr<Node> to(U&& value) {
+        if (!value) return std::make_shared<NullNode>();
+        return Convert<T>::to(detail::forwardElement<U>(*value));
+    }
+    static std::optional<T> from(const Node& node) {
+        if (node.isNull()) return std::nullopt;
+        return Convert<T>::from(node);
+    }
+};
+
+// Reading a variant picks the first alternative that accepts the node.
+template <typename... Ts>
+struct Convert<std::variant<Ts...>> {
+    template <typename U>
+    static std::shared_ptr<Node> to(U&& value) {
+        return std::visit([](auto&& alternative) {
+            using Alternative = std::remove_cvref_t<decltype(alternative)>;
+            return Convert<Alternative>::to(std::forward<decltype(alternative)>(alternative));
+        }, std::forward<U>(value));
+    }
+    static std::variant<Ts...> from(const Node& node) {
+        std::optional<std::variant<Ts...>> result;
+        ([&] {
+            if (result) return;
+            try {
+                result.emplace(std::in_place_type<Ts>, Convert<Ts>::from(node));
+            } catch (const WrongObjectType&) { }
+        }(), ...);
+        if (!result) throw WrongObjectType("No variant alternative matches this node.");
+        return *std::move(result);
+    }
+};
+
+// Tuples and pairs map to fixed-length lists.
+template <typename... Ts>
+struct Convert<std::tuple<Ts...>> {
+    template <typename U>
+    static std::shared_ptr<Node> to(U&& tuple) {
+        auto node = std::make_shared<ListNode>();
+        node->reserve(sizeof...(Ts));
+        std::apply([&](auto&... element) {
+            (node->addChild(Convert<std::remove_cvref_t<decltype(element)>>::to(detail::forwardElement<U>(element))), ...);
+        }, tuple);
+        return node;
+    }
+    static std::tuple<Ts...> from(const Node& node) {
+        auto& children = detail::asList(node).getChildren();
+        if (children.size() != sizeof...(Ts))
+            throw WrongObjectType("List does not have " + std::to_string(sizeof...(Ts)) + " elements.");
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            return std::tuple<Ts...>(Convert<Ts>::from(*children[I])...);
+        }(std::index_sequence_for<Ts...>{});
+    }
+};
+
+template <typename A, typename B>
+struct Convert<std::pair<A, B>> {
+    template <typename U>
+    static std::shared_ptr<Node> to(U&& pair) {
+        return Convert<std::tuple<A, B>>::to(std::tuple<A, B>(std::forward<U>(pair)));
+    }
+    static std::pair<A, B> from(const Node& node) {
+        auto [a, b] = Convert<std::tuple<A, B>>::from(node);
+        return {std::move(a), std::move(b)};
+    }
+};
+
+};
+
+#endif
@@ -1,5 +1,16 @@
 #include "json.hpp"
-
+#include "stats.hpp"
+#include "trace.hpp"
+#include "simd.hpp"
+#include "mapped.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <charconv>
+#include <cstring>
 #include <sstream>
 #include <fstream>
 
@@ -21,6 +32,14 @@ WrongObjectType WrongObjectType::NotList() {
     return WrongObjectType("This is not a list object.");
 }
 
+WrongObjectType WrongObjectType::NotNumber() {
+    return WrongObjectType("This is not a number.");
+}
+
+WrongObjectType WrongObjectType::OutOfRange() {
+    return WrongObjectType("This number is out of range.");
+}
+
 WrongObjectType WrongObjectType::Unknown() {
     return WrongObjectType("Unknown object type.");
 }
@@ -33,8 +52,6 @@ bool Node::isNull() const {
     return type_ == ValueType::Concrete::Null;
 }
 
-ValueType::Concrete Node::type() const { return type_; }
-
 NullNode::NullNode() : Node(ValueType::Concrete::Null) { }
 
 std::string NullNode::pretty() const { return "null"; }
@@ -43,6 +60,92 @@ std::ostream& NullNode::dump(std::ostream& os) const {
     return os << "null";
 }
 
+namespace {
+
+// The worklist of the outermost container destructor running on this thread.
+// It lives on that destructor's stack; a plain pointer is never destroyed, so
+// containers with static storage duration can still be torn down at exit.
+thread_local std::vector<std::shared_ptr<Node>>* worklist = nullptr;
+
+// Moves a child this container alone owns onto the worklist, so that its own
+// children are released after the current destructor returns.
+void defer(std::shared_ptr<Node>& child) {
+    if (!child || child.use_count() != 1) return;
+    auto type = child->type();
+    if (type != ValueType::Concrete::Object && type != ValueType::Concrete::List) return;
+    try {
+        worklist->push_back(std::move(child));
+    } catch (...) {
+        // Out of memory: the child is released recursively instead.
+    }
+}
+
+// Defers the children that `children` yields. Nested destructors only add to
+// the worklist; the outermost one destroys its entries until none are left,
+// so any depth is released at constant stack.
+template <typename Range, typename Child>
+void reclaim(Range& children, Child child) {
+    if (worklist) {
+        for (auto& entry : children) defer(child(entry));
+        return;
+    }
+    std::vector<std::shared_ptr<Node>> pending;
+    worklist = &pending;
+    for (auto& entry : children) defer(child(entry));
+    while (!pending.empty()) {
+        std::shared_ptr<Node> node = std::move(pending.back());
+        pending.pop_back();
+        node.reset();
+    }
+    worklist = nullptr;
+}
+
+// Destroys documents handed over by reclaimInBackground() on its own thread.
+class Reclaimer {
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::vector<std::shared_ptr<Node>> queue;
+    bool stopping = false;
+    std::thread thread;
+
+    void run() {
+        std::unique_lock lock(mutex);
+        for (;;) {
+            ready.wait(lock, [&] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+            std::vector<std::shared_ptr<Node>> batch;
+            batch.swap(queue);
+            lock.unlock();
+            batch.clear();
+            lock.lock();
+        }
+    }
+public:
+    Reclaimer() : thread([this] { run(); }) { }
+    ~Reclaimer() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        ready.notify_one();
+        thread.join();
+    }
+    void push(std::shared_ptr<Node> root) {
+        {
+            std::lock_guard lock(mutex);
+            queue.push_back(std::move(root));
+        }
+        ready.notify_one();
+    }
+};
+
+}
+
+ObjectNode::~ObjectNode() {
+    reclaim(children, [](auto& entry) -> std::shared_ptr<Node>& { return entry.second; });
+}
+
 void ObjectNode::addOrEditChild(std::string key, std::shared_ptr<Node> child) { 
     children[key] = std::move(child);
 }
@@ -50,7 +153,7 @@ void ObjectNode::addOrEditChild(std::string key, std::shared_ptr<Node> child) {
 std::string ObjectNode::pretty() const {
     std::ostringstream os;
     os << "{ ";
-    for (auto [key, value] : children) {
+    for (const auto& [key, value] : children) {
         os << " " << "\"" << key << "\"" << " : " << value->pretty() << ", ";
     }
     os << " }";
@@ -60,8 +163,8 @@ std::string ObjectNode::pretty() const {
 std::ostream& ObjectNode::dump(std::ostream& os) const {
     os << "{";
     for (auto it = children.begin(); it != children.end(); ++it) {
-        auto [key, value] = *it;
-        os << '"' << key << '"' << ":";
+        const auto& [key, value] = *it;
+        writeEscaped(os, key) << ":";
         value->dump(os);
         os << (std::next(it) == children.end() ? "" : ",");
     }
@@ -69,13 +172,25 @@ std::ostream& ObjectNode::dump(std::ostream& os) const {
     return os;
 }
 
-std::map<std::string, std::shared_ptr<Node>>& ObjectNode::getChildren() {
+ObjectNode::Children& ObjectNode::getChildren() {
+    return children;
+}
+
+const ObjectNode::Children& ObjectNode::getChildren() const {
     return children;
 }
 
 ListNode::ListNode() : Node(ValueType::Concrete::List) { }
 
-void ListNode::addChild(std::shared_ptr<Node> child) { children.push_back(child); }
+ListNode::ListNode(ArenaAllocator<Node> allocator) : Node(ValueType::Concrete::List), children(allocator) { }
+
+ListNode::~ListNode() {
+    reclaim(children, [](std::shared_ptr<Node>& child) -> std::shared_ptr<Node>& { return child; });
+}
+
+void ListNode::addChild(std::shared_ptr<Node> child) { children.push_back(std::move(child)); }
+
+void ListNode::reserve(size_t size) { children.reserve(size); }
 
 std::string ListNode::pretty() const {
     std::ostringstream os;
@@ -101,7 +216,11 @@ std::shared_ptr<Node> ListNode::get(size_t idx) {
     return children[idx];
 }
 
-std::vector<std::shared_ptr<Node>>& ListNode::getChildren() {
+ListNode::Children& ListNode::getChildren() {
+    return children;
+}
+
+const ListNode::Children& ListNode::getChildren() const {
     return children;
 }
 
@@ -110,9 +229,8 @@ std::string ValueNode<bool>::pretty() const {
     return value_ ? "true" : "false";
 }
 
-template<>
 std::string ValueNode<std::string>::pretty() const {
-    return "\"" + value_ + "\"";
+    return "\"" + value() + "\"";
 }
 
 template<>
@@ -120,128 +238,355 @@ std::ostream& ValueNode<bool>::dump(std::ostream& os) const {
     return os << (value_ ? "true" : "false");
 }
 
-template<>
 std::ostream& ValueNode<std::string>::dump(std::ostream& os) const {
-    return os << "\"" << value_ << "\"";
+    return writeEscaped(os, text);
 }
 
-std::shared_ptr<Node> parse(std::string& str) {
-    std::ostringstream oss;
-
-    // Remove whitespace, but not inside strings
-    bool inside = false;
-    for (char ch : str) {
-        if (ch == '"') inside = !inside;
-        if (std::isspace(ch) && !inside) continue;
-        oss << ch;
-    }
-
-    std::string str_clean = oss.str();
+namespace {
 
-    size_t index = 0;
-    return parseRecursively(str_clean, index);
+bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
 }
 
-std::shared_ptr<Node> parseRecursively(std::string& json, size_t& index) {
-    switch (json[index]) {
-        case '{':
-            return std::dynamic_pointer_cast<Node, ObjectNode>(parseObject(json, index));
-        case '[':
-            return std::dynamic_pointer_cast<Node, ListNode>(parseList(json, index));
-        default:
-            return parseValue(json, index);
-    }
+bool isDigit(char c) {
+    return '0' <= c && c <= '9';
 }
 
-std::shared_ptr<ObjectNode> parseObject(std::string& json, size_t& index) {
-    ++index; // Skip opening curly brace
-
-    // Create node
-    auto node = std::make_shared<ObjectNode>();
-
-    while (json[index] != '}') {
-        // Parse key
-        std::ostringstream key;
-        if (json[index++] != '"') throw Malformed();
-        while (json[index] != '"') {
-            key << json[index++];
+char* writeUtf8(char* out, uint32_t cp) {
+    if (cp < 0x80) {
+        *out++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (cp >> 6));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | (cp >> 12));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | (cp >> 18));
+        *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+// Allocates a node in the arena, or on its own without one.
+template <typename T, typename... Args>
+std::shared_ptr<T> makeNode(const std::shared_ptr<Arena>& arena, Args&&... args) {
+    if (arena) return std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args>(args)...);
+    return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
+// Copies text into the arena, which the node holding it keeps alive.
+std::string_view keepText(Arena& arena, std::string_view text) {
+    char* copy = static_cast<char*>(arena.allocate(text.size(), 1));
+    std::memcpy(copy, text.data(), text.size());
+    return std::string_view(copy, text.size());
+}
+
+// True if all eight bytes of a little-endian word are ASCII digits.
+bool eightDigits(const char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return ((v & 0xF0F0F0F0F0F0F0F0) | (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+}
+
+// Recursive descent. In situ, strings are unescaped inside the buffer: an
+// escape never decodes to more bytes than it takes, so the output always fits
+// where the input was. Otherwise the buffer is never written and escaped
+// strings are decoded into a scratch string.
+//
+// A padded buffer ends in zeros that no token continues through, so scans
+// run without bounds checks: they stop at the first padding byte at the
+// latest and the following check throws.
+template <bool Padded>
+class Parser {
+private:
+    char* p;
+    char* end;
+    // Where scans may stop: the padding's zeros end them before it.
+    char* limit;
+    bool inSitu;
+    ParseOptions options;
+    // Owner of the input, kept alive by strings stored by reference.
+    std::shared_ptr<const void> source;
+    std::string scratch;
+    const Kernels& scan = kernels();
+
+    bool more() const { return Padded || p != end; }
+    template <typename T, typename... Args>
+    std::shared_ptr<T> make(Args&&... args) {
+        return makeNode<T>(options.arena, std::forward<Args>(args)...);
+    }
+    std::string_view keep(std::string_view text) { return keepText(*options.arena, text); }
+    char peek() {
+        if (more() && isSpace(*p)) p = const_cast<char*>(scan.skipWhitespace(p, limit));
+        if (!Padded && p == end) throw Malformed();
+        return *p;
+    }
+    void expect(char c) {
+        if (peek() != c) throw Malformed();
+        ++p;
+    }
+    void literal(const char* word, size_t length) {
+        if (!Padded && static_cast<size_t>(end - p) < length) throw Malformed();
+        if (std::memcmp(p, word, length) != 0) throw Malformed();
+        p += length;
+    }
+    uint32_t hex4() {
+        if (!Padded && end - p < 4) throw Malformed();
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *p++;
+            value <<= 4;
+            if (isDigit(c)) value |= c - '0';
+            else if ('a' <= c && c <= 'f') value |= c - 'a' + 10;
+            else if ('A' <= c && c <= 'F') value |= c - 'A' + 10;
+            else throw Malformed();
+        }
+        return value;
+    }
+    // Decodes the escape after a backslash into `out`, which has room for
+    // four bytes; returns the end of what was written.
+    char* escape(char* out) {
+        if (!more()) throw Malformed();
+        switch (*p++) {
+            case '"': *out++ = '"'; break;
+            case '\\': *out++ = '\\'; break;
+            case '/': *out++ = '/'; break;
+            case 'b': *out++ = '\b'; break;
+            case 'f': *out++ = '\f'; break;
+            case 'n': *out++ = '\n'; break;
+            case 'r': *out++ = '\r'; break;
+            case 't': *out++ = '\t'; break;
+            case 'u': {
+                uint32_t cp = hex4();
+                if (0xD800 <= cp && cp < 0xDC00) {
+                    literal("\\u", 2);
+                    uint32_t low = hex4();
+                    if (low < 0xDC00 || low >= 0xE000) throw Malformed();
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                } else if (0xDC00 <= cp && cp < 0xE000) {
+                    throw Malformed();
+                }
+                out = writeUtf8(out, cp);
+                break;
+            }
+            default:
+                throw Malformed();
+        }
+        return out;
+    }
+    // Advances to the next quote, backslash or control character.
+    void scanString() {
+        p = const_cast<char*>(scan.findStringSpecial(p, limit));
+    }
+    // Called after the opening quote. Sets `escaped` if the string had to be
+    // unescaped, i.e. does not appear as such in the input.
+    std::string_view string(bool* escaped = nullptr) {
+        char* start = p;
+        scanString();
+        if (more() && *p == '"') return std::string_view(start, p++ - start);
+        if (escaped) *escaped = true;
+        char* out = p;
+        if (!inSitu) scratch.assign(start, p);
+        for (;;) {
+            if (!more() || static_cast<unsigned char>(*p) < 0x20) throw Malformed();
+            if (*p == '"') {
+                ++p;
+                if (inSitu) return std::string_view(start, out - start);
+                return scratch;
+            }
+            ++p;
+            char decoded[4];
+            char* decodedEnd = escape(decoded);
+            char* run = p;
+            scanString();
+            if (inSitu) {
+                out = std::copy(decoded, decodedEnd, out);
+                out = std::copy(run, p, out);
+            } else {
+                scratch.append(decoded, decodedEnd);
+                scratch.append(run, p);
+            }
+        }
+    }
+    void digits() {
+        char* first = p;
+        if constexpr (Padded) {
+            while (eightDigits(p)) p += 8;
+        }
+        while (more() && isDigit(*p)) ++p;
+        if (p == first) throw Malformed();
+    }
+    std::shared_ptr<Node> number() {
+        char* start = p;
+        bool isFloat = false;
+        if (*p == '-') ++p;
+        if (more() && *p == '0') ++p;
+        else digits();
+        if (more() && *p == '.') {
+            ++p;
+            digits();
+            isFloat = true;
+        }
+        if (more() && (*p == 'e' || *p == 'E')) {
+            ++p;
+            if (more() && (*p == '+' || *p == '-')) ++p;
+            digits();
+            isFloat = true;
+        }
+        if (options.rawNumbers) {
+            // Nine digits always fit an int; longer integers are checked.
+            size_t length = p - start - (*start == '-');
+            int ignored;
+            if (!isFloat && (length <= 9 || std::from_chars(start, p, ignored).ec == std::errc()))
+                return rawNumber<int>(start);
+            return rawNumber<float>(start);
+        }
+        // Numbers a float or an int cannot hold keep their lexeme, so they
+        // dump unchanged and number<T>() reads them at full precision.
+        if (!isFloat) {
+            int value;
+            if (std::from_chars(start, p, value).ec == std::errc()) return make<ValueNode<int>>(value);
+            return rawNumber<float>(start);
+        }
+        float value;
+        if (std::from_chars(start, p, value).ec != std::errc()) return rawNumber<float>(start);
+        return make<ValueNode<float>>(value);
+    }
+    template <typename T>
+    std::shared_ptr<Node> rawNumber(char* start) {
+        std::string_view lexeme(start, p - start);
+        if (inSitu) return make<ValueNode<T>>(lexeme, Borrowed());
+        if (options.arena) return make<ValueNode<T>>(keep(lexeme), Borrowed());
+        return make<ValueNode<T>>(std::string(lexeme));
+    }
+    std::shared_ptr<Node> object() {
+        auto node = make<ObjectNode>(ArenaAllocator<Node>(options.arena));
+        if (peek() == '}') {
+            ++p;
+            return node;
+        }
+        for (;;) {
+            expect('"');
+            std::string key(string());
+            expect(':');
+            node->addOrEditChild(std::move(key), value());
+            if (peek() == '}') {
+                ++p;
+                return node;
+            }
+            expect(',');
         }
-        ++index; // Skip final quote
-        ++index; // Skip colon
-
-        // Parse value
-        std::shared_ptr<Node> value = parseRecursively(json, index);
-
-        if (json[index] != '}') ++index; // Skip comma
-
-        // Add pair
-        node->addOrEditChild(key.str(), value);
     }
+    std::shared_ptr<Node> list() {
+        auto node = make<ListNode>(ArenaAllocator<Node>(options.arena));
+        if (peek() == ']') {
+            ++p;
+            return node;
+        }
+        for (;;) {
+            node->addChild(value());
+            if (peek() == ']') {
+                ++p;
+                return node;
+            }
+            expect(',');
+        }
+    }
+public:
+    // Only written to when `inSitu` is set.
+    Parser(char* data, size_t size, bool inSitu, ParseOptions options, std::shared_ptr<const void> source)
+        : p(data), end(data + size), limit(Padded ? end + padding : end), inSitu(inSitu), options(options),
+          source(std::move(source)) { }
+    std::shared_ptr<Node> value() {
+        char c = peek();
+        if (c == '-' || isDigit(c)) return number();
+        ++p;
+        switch (c) {
+            case '{':
+                return object();
+            case '[':
+                return list();
+            case '"': {
+                bool escaped = false;
+                std::string_view text = string(&escaped);
+                if (inSitu) return make<ValueNode<std::string>>(text, Borrowed());
+                if (options.referenceStrings && !escaped && text.size() >= options.referenceStrings) {
+                    if (source) return make<ValueNode<std::string>>(text, source);
+                    return make<ValueNode<std::string>>(text, Borrowed());
+                }
+                if (options.arena) return make<ValueNode<std::string>>(keep(text), Borrowed());
+                return make<ValueNode<std::string>>(std::string(text));
+            }
+            case 't':
+                literal("rue", 3);
+                return make<ValueNode<bool>>(true);
+            case 'f':
+                literal("alse", 4);
+                return make<ValueNode<bool>>(false);
+            case 'n':
+                literal("ull", 3);
+                return make<NullNode>();
+            default:
+                throw Malformed();
+        }
+    }
+    std::shared_ptr<Node> document() {
+        auto root = value();
+        while (p < end && isSpace(*p)) ++p;
+        if (p != end) throw Malformed();
+        return root;
+    }
+};
 
-    ++index; // Skip closing curly brace
+template <bool Padded>
+std::shared_ptr<Node> parseNodes(char* data, size_t size, bool inSitu, ParseOptions options,
+                                 std::shared_ptr<const void> source = nullptr) {
+    PhaseScope build(Phase::Build);
+    TraceScope trace(Operation::Parse, size);
+    if (!kernels().validUtf8(data, data + size)) throw Malformed();
+    return Parser<Padded>(data, size, inSitu, options, std::move(source)).document();
+}
 
-    return node;
 }
 
-std::shared_ptr<ListNode> parseList(std::string& json, size_t& index) {
-    ++index; // Skip opening square bracket
+Json::Json(std::shared_ptr<Node> root, std::shared_ptr<Arena> arena) : root(root), arena(std::move(arena)) { }
 
-    // Create node
-    auto node = std::make_shared<ListNode>();
+Json::Json(const char* value) : Json(std::string(value)) { }
 
-    while (json[index] != ']') {
-        node->addChild(parseRecursively(json, index));
-        if (json[index] != ']') ++index; // Skip comma
+Json Json::fromFile(const std::string filename, ParseOptions options) {
+    PhaseScope load(Phase::Load);
+    TraceScope trace(Operation::FromFile);
+    if (options.referenceStrings) {
+        auto file = std::make_shared<const MappedFile>(filename);
+        std::string_view text = file->view();
+        trace.bytes(text.size());
+        // Parsing never writes outside in-situ mode.
+        return Json(parseNodes<false>(const_cast<char*>(text.data()), text.size(), false, options, file), options.arena);
     }
-
-    ++index; // Skip closing square bracket
-
-    return node;
+    PaddedString text = PaddedString::load(filename);
+    trace.bytes(text.size());
+    return parse(text, options);
 }
 
-std::shared_ptr<Node> parseValue(std::string& json, size_t& index) {
-    // Bool
-    if (json.substr(index, 4) == "true") {
-        index += 4;
-        return std::shared_ptr<Node>((Node*)(new ValueNode<bool>(true)));
-    }
-    if (json.substr(index, 5) == "false") {
-        index += 5;
-        return std::shared_ptr<Node>((Node*)(new ValueNode<bool>(false)));
-    }
-    // Number
-    auto is_number = [](char ch) { return '0' <= ch && ch <= '9'; };
-    if (is_number(json[index])) {
-        std::ostringstream number;
-        bool is_float = false;
-        while(json[index] == '.' || is_number(json[index])) {
-            if (json[index] == '.') is_float = true;
-            number << json[index++];
-        }
-        if (is_float) return std::shared_ptr<Node>((Node*)(new ValueNode<float>(std::atof(number.str().c_str()))));
-        return std::shared_ptr<Node>((Node*)(new ValueNode<int>(std::atoi(number.str().c_str()))));
-    }
-    // String
-    if (json[index++] == '"') {
-        std::ostringstream string;
-        while (json[index] != '"') {
-            string << json[index++];
-        }
-        ++index; // Skip last quote
-        return std::shared_ptr<Node>((Node*)(new ValueNode<std::string>(string.str())));
-    }
-    throw new Malformed();
+Json Json::parse(std::string_view json, ParseOptions options) {
+    // Parsing never writes outside in-situ mode.
+    return Json(parseNodes<false>(const_cast<char*>(json.data()), json.size(), false, options), options.arena);
 }
 
-Json::Json(std::shared_ptr<Node> root) : root(root) { }
+Json Json::parse(PaddedBuffer json, ParseOptions options) {
+    return Json(parseNodes<true>(json.data(), json.size(), false, options), options.arena);
+}
 
-Json::Json(const char* value) : Json(std::string(value)) { }
+Json Json::parseInSitu(std::span<char> buffer, ParseOptions options) {
+    return Json(parseNodes<false>(buffer.data(), buffer.size(), true, options), options.arena);
+}
 
-Json Json::fromFile(const std::string filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) throw std::runtime_error("File not found.");
-    std::string str((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    return parse(str);
+Json Json::parseInSitu(PaddedBuffer buffer, ParseOptions options) {
+    return Json(parseNodes<true>(buffer.data(), buffer.size(), true, options), options.arena);
 }
 
 Json Json::array(std::initializer_list<Json>& list) {
@@ -253,7 +598,20 @@ Json Json::array(std::initializer_list<Json>& list) {
 }
 
 std::ostream& Json::dump(std::ostream& os) const {
+    PhaseScope dump(Phase::Dump);
+    TraceScope trace(Operation::Dump);
+#ifdef JSON_TRACE
+    auto begin = os.tellp();
+    root->dump(os);
+    if (begin != -1 && os.tellp() != -1) trace.bytes(os.tellp() - begin);
+    return os;
+#else
     return root->dump(os);
+#endif
+}
+
+const Node& Json::node() const {
+    return *root;
 }
 
 Json::Json(std::initializer_list<std::pair<std::string, Json>> list) {
@@ -264,52 +622,264 @@ Json::Json(std::initializer_list<std::pair<std::string, Json>> list) {
     root = node;
 }
 
-Json::View Json::operator[] (std::string key) {
-    if(root->type() != ValueType::Concrete::Object)
-        throw WrongObjectType::NotObject();
-    auto object = std::dynamic_pointer_cast<ObjectNode>(root);
-    auto it = object->getChildren().find(key);
-    if(it == object->getChildren().end()) {
-        auto newNode = std::make_shared<NullNode>();
-        object->addOrEditChild(key, newNode);
-        return View(newNode);
+namespace {
+
+// The child a pointer token names, for extract().
+std::shared_ptr<Node>& childAt(Node& node, const std::string& token, std::string_view pointer) {
+    auto missing = [&] { return std::out_of_range("No value at " + std::string(pointer) + "."); };
+    if (node.type() == ValueType::Concrete::Object) {
+        auto& children = static_cast<ObjectNode&>(node).getChildren();
+        auto it = children.find(token);
+        if (it == children.end()) throw missing();
+        return it->second;
+    }
+    if (node.type() != ValueType::Concrete::List) throw WrongObjectType::NotObject();
+    auto& children = static_cast<ListNode&>(node).getChildren();
+    size_t index;
+    auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), index);
+    if (error != std::errc() || end != token.data() + token.size() || index >= children.size()) throw missing();
+    return children[index];
+}
+
+template <typename T>
+std::shared_ptr<Node> copyNumber(const ValueNode<T>& node, const std::shared_ptr<Arena>& arena) {
+    std::string_view lexeme = node.lexeme();
+    if (lexeme.empty()) return makeNode<ValueNode<T>>(arena, node.value());
+    if (arena) return makeNode<ValueNode<T>>(arena, keepText(*arena, lexeme), Borrowed());
+    return makeNode<ValueNode<T>>(arena, std::string(lexeme));
+}
+
+std::shared_ptr<Node> copyTree(const Node& node, const std::shared_ptr<Arena>& arena) {
+    switch (node.type()) {
+        case ValueType::Concrete::Object: {
+            auto copy = makeNode<ObjectNode>(arena, ArenaAllocator<Node>(arena));
+            auto& children = copy->getChildren();
+            for (auto& [key, child] : static_cast<const ObjectNode&>(node).getChildren())
+                children.emplace_hint(children.end(), key, copyTree(*child, arena));
+            return copy;
+        }
+        case ValueType::Concrete::List: {
+            auto& children = static_cast<const ListNode&>(node).getChildren();
+            auto copy = makeNode<ListNode>(arena, ArenaAllocator<Node>(arena));
+            copy->reserve(children.size());
+            for (auto& child : children) copy->addChild(copyTree(*child, arena));
+            return copy;
+        }
+        case ValueType::Concrete::String: {
+            std::string_view text = static_cast<const ValueNode<std::string>&>(node).view();
+            if (arena) return makeNode<ValueNode<std::string>>(arena, keepText(*arena, text), Borrowed());
+            return makeNode<ValueNode<std::string>>(arena, std::string(text));
+        }
+        case ValueType::Concrete::Int:
+            return copyNumber(static_cast<const ValueNode<int>&>(node), arena);
+        case ValueType::Concrete::Float:
+            return copyNumber(static_cast<const ValueNode<float>&>(node), arena);
+        case ValueType::Concrete::Bool:
+            return makeNode<ValueNode<bool>>(arena, static_cast<const ValueNode<bool>&>(node).value());
+        default:
+            return makeNode<NullNode>(arena);
     }
-    return View(it->second);
+}
+
+}
+
+Json Json::extract(std::string_view pointer) {
+    std::vector<std::string> tokens = pointerTokens(pointer);
+    if (tokens.empty()) {
+        Json whole(std::move(root), arena);
+        root = std::make_shared<NullNode>();
+        return whole;
+    }
+    std::shared_ptr<Node>* parent = &root;
+    for (size_t i = 0; i + 1 < tokens.size(); ++i) parent = &childAt(**parent, tokens[i], pointer);
+    std::shared_ptr<Node>& slot = childAt(**parent, tokens.back(), pointer);
+    Json detached(std::move(slot), arena);
+    if ((*parent)->type() == ValueType::Concrete::Object) {
+        static_cast<ObjectNode&>(**parent).getChildren().erase(tokens.back());
+    } else {
+        auto& children = static_cast<ListNode&>(**parent).getChildren();
+        children.erase(children.begin() + (&slot - children.data()));
+    }
+    return detached;
+}
+
+Json Json::relocate(std::shared_ptr<Arena> arena) const {
+    PhaseScope build(Phase::Build);
+    return Json(copyTree(*root, arena), arena);
+}
+
+Json::View Json::operator[] (std::string_view key) {
+    return View(root, &arena)[key];
 }
 
 Json::View Json::operator[] (size_t idx) {
-    if (root->type() != ValueType::Concrete::List)
+    return View(root, &arena)[idx];
+}
+
+Json::Items Json::items() {
+    return View(root, &arena).items();
+}
+
+Json::Elements Json::elements() {
+    return View(root, &arena).elements();
+}
+
+Json::Elements Json::slice(size_t begin, size_t end) {
+    return View(root, &arena).slice(begin, end);
+}
+
+Json::Elements Json::subspan(size_t offset, size_t count) {
+    return View(root, &arena).subspan(offset, count);
+}
+
+Json::View Json::View::operator[] (std::string_view key) {
+    PhaseScope lookup(Phase::Lookup);
+    TraceScope trace(Operation::Lookup);
+    if(type() != ValueType::Concrete::Object)
+        throw WrongObjectType::NotObject();
+    auto& children = static_cast<ObjectNode&>(**slot).getChildren();
+    auto it = children.find(key);
+    if(it == children.end())
+        it = children.emplace(std::string(key), std::make_shared<NullNode>()).first;
+    return View(it->second, arena);
+}
+
+Json::View Json::View::operator[] (size_t idx) {
+    PhaseScope lookup(Phase::Lookup);
+    TraceScope trace(Operation::Lookup);
+    if(type() != ValueType::Concrete::List)
         throw WrongObjectType::NotList();
-    auto list = std::dynamic_pointer_cast<ListNode>(root);
-    return View(list->getChildren()[idx]);
+    return View(static_cast<ListNode&>(**slot).getChildren()[idx], arena);
 }
 
-Json::View Json::View::operator[] (std::string key) {
-    if((*node)->type() != ValueType::Concrete::Object)
+Json::Items Json::View::items() const {
+    if(type() != ValueType::Concrete::Object)
         throw WrongObjectType::NotObject();
-    auto object = std::dynamic_pointer_cast<ObjectNode>(*node);
-    auto it = object->getChildren().find(key);
-    if(it == object->getChildren().end()) {
-        auto newNode = std::make_shared<NullNode>();
-        object->addOrEditChild(key, newNode);
-        return View(newNode);
+    return Items(static_cast<ObjectNode&>(**slot), arena);
+}
+
+Json::Elements Json::View::elements() const {
+    if(type() != ValueType::Concrete::List)
+        throw WrongObjectType::NotList();
+    return Elements(static_cast<ListNode&>(**slot), arena);
+}
+
+Json::View Json::View::adopt(Json&& other) {
+    static const std::shared_ptr<Arena> heap;
+    const std::shared_ptr<Arena>& target = arena ? *arena : heap;
+    if (other.arena == target) {
+        *slot = std::move(other.root);
+    } else {
+        PhaseScope build(Phase::Build);
+        *slot = copyTree(*other.root, target);
     }
-    return View(it->second);
+    other.root = std::make_shared<NullNode>();
+    other.arena.reset();
+    return *this;
 }
 
-Json::View Json::View::operator[] (size_t idx) {
-    if((*node)->type() != ValueType::Concrete::List)
+Json::Elements Json::View::slice(size_t begin, size_t end) const {
+    if(type() != ValueType::Concrete::List)
         throw WrongObjectType::NotList();
-    auto list = std::dynamic_pointer_cast<ListNode>(*node);
-    return View(list->getChildren()[idx]);
+    auto& children = static_cast<ListNode&>(**slot).getChildren();
+    end = std::min(end, children.size());
+    begin = std::min(begin, end);
+    return Elements(children.begin() + begin, children.begin() + end, arena);
+}
+
+Json::Elements Json::View::subspan(size_t offset, size_t count) const {
+    return slice(offset, count > SIZE_MAX - offset ? SIZE_MAX : offset + count);
+}
+
+std::ostream& Json::Elements::dump(std::ostream& os) const {
+    os << "[";
+    for (auto it = first; it != last; ++it) {
+        it->get()->dump(os);
+        os << (std::next(it) == last ? "" : ",");
+    }
+    os << "]";
+    return os;
+}
+
+std::ostream& Json::View::dump(std::ostream& os) const {
+    return (*slot)->dump(os);
+}
+
+void reclaimInBackground(Json&& document) {
+    static Reclaimer reclaimer;
+    reclaimer.push(std::move(document.root));
 }
 
-Json fromFile(const std::string filename) {
-    return Json::fromFile(filename);
+Json fromFile(const std::string filename, ParseOptions options) {
+    return Json::fromFile(filename, options);
+}
+
+Json parse(std::string_view json, ParseOptions options) {
+    return Json::parse(json, options);
+}
+
+Json parse(PaddedBuffer json, ParseOptions options) {
+    return Json::parse(json, options);
+}
+
+Json parseInSitu(std::span<char> buffer, ParseOptions options) {
+    return Json::parseInSitu(buffer, options);
+}
+
+Json parseInSitu(PaddedBuffer buffer, ParseOptions options) {
+    return Json::parseInSitu(buffer, options);
 }
 
 Json array(std::initializer_list<Json> list) {
     return Json::array(list);
 }
 
+std::ostream& writeEscaped(std::ostream& os, std::string_view str) {
+    os << '"';
+    return writeEscapedRun(os, str) << '"';
+}
+
+std::ostream& writeEscapedRun(std::ostream& os, std::string_view str) {
+    static constexpr char hex[] = "0123456789abcdef";
+    const Kernels& scan = kernels();
+    const char* end = str.data() + str.size();
+    size_t start = 0;
+    for (size_t i = 0; i < str.size(); ++i) {
+        i = scan.findStringSpecial(str.data() + i, end) - str.data();
+        if (i == str.size()) break;
+        unsigned char ch = str[i];
+        os.write(str.data() + start, i - start);
+        start = i + 1;
+        switch (ch) {
+            case '"': os << "\\\""; break;
+            case '\\': os << "\\\\"; break;
+            case '\n': os << "\\n"; break;
+            case '\r': os << "\\r"; break;
+            case '\t': os << "\\t"; break;
+            case '\b': os << "\\b"; break;
+            case '\f': os << "\\f"; break;
+            default: os << "\\u00" << hex[ch >> 4] << hex[ch & 15];
+        }
+    }
+    return os.write(str.data() + start, str.size() - start);
+}
+
+std::vector<std::string> pointerTokens(std::string_view pointer) {
+    std::vector<std::string> tokens;
+    if (pointer.empty()) return tokens;
+    if (pointer[0] != '/') throw std::runtime_error("Invalid JSON pointer.");
+    std::string token;
+    for (size_t i = 1; i <= pointer.size(); ++i) {
+        if (i == pointer.size() || pointer[i] == '/') {
+            tokens.push_back(std::move(token));
+            token.clear();
+        } else if (pointer[i] == '~' && i + 1 < pointer.size() && (pointer[i + 1] == '0' || pointer[i + 1] == '1')) {
+            token.push_back(pointer[++i] == '0' ? '~' : '/');
+        } else {
+            token.push_back(pointer[i]);
+        }
+    }
+    return tokens;
+}
+
 }; // namespace json
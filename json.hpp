@@ -14,6 +14,15 @@
 #include <optional>
 #include <initializer_list>
 #include <utility>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <charconv>
+#include <limits>
+
+#include "arena.hpp"
+#include "padded.hpp"
 
 namespace json {
 
@@ -23,6 +32,9 @@ concept type_is_one_of = (std::same_as<T, others> or ...);
 template <typename T>
 concept is_json_leaf_type = type_is_one_of<T, float, int, std::string, bool>;
 
+template <typename T>
+concept is_json_number_type = is_json_leaf_type<T> && type_is_one_of<T, float, int>;
+
 class Malformed : public std::exception {
 public:
     const char* what() const throw () override;
@@ -53,13 +65,13 @@ public:
     }
     template <is_json_leaf_type T>
     constexpr static Concrete get() {
-        if(typeid(T) == typeid(std::string))
+        if constexpr (std::same_as<T, std::string>)
             return Concrete::String;
-        if(typeid(T) == typeid(float))
+        else if constexpr (std::same_as<T, float>)
             return Concrete::Float;
-        if(typeid(T) == typeid(int))
+        else if constexpr (std::same_as<T, int>)
             return Concrete::Int;
-        if(typeid(T) == typeid(bool))
+        else if constexpr (std::same_as<T, bool>)
             return Concrete::Bool;
         return Concrete::Null;
     }
@@ -73,6 +85,8 @@ public:
     const char* what() const throw() override;
     static WrongObjectType NotObject();
     static WrongObjectType NotList();
+    static WrongObjectType NotNumber();
+    static WrongObjectType OutOfRange();
     template <is_json_leaf_type T>
     static WrongObjectType NotLeaf() {
         return WrongObjectType(std::string("This is not leaf type ") + ValueType::toString(ValueType::get<T>()) + ".");
@@ -87,7 +101,7 @@ protected:
     Node(ValueType::Concrete type);
 public:
     virtual ~Node();
-    ValueType::Concrete type() const;
+    ValueType::Concrete type() const { return type_; }
     virtual std::string pretty() const = 0;
     virtual std::ostream& dump(std::ostream& os) const = 0;
     bool isNull() const;
@@ -101,12 +115,23 @@ public:
 };
 
 class ObjectNode : public Node {
+public:
+    // Transparent comparator so lookups by string_view allocate nothing.
+    typedef std::map<std::string, std::shared_ptr<Node>, std::less<>,
+                     ArenaAllocator<std::pair<const std::string, std::shared_ptr<Node>>>> Children;
 private:
-    std::map<std::string, std::shared_ptr<Node>> children;
+    Children children;
 public:
     ObjectNode() : Node(ValueType::Concrete::Object) { }
+    // Keeps the map's nodes in the allocator's arena.
+    explicit ObjectNode(ArenaAllocator<Node> allocator)
+        : Node(ValueType::Concrete::Object), children(std::less<>(), allocator) { }
+    // Containers are torn down from a worklist rather than recursively, so
+    // dropping a tree of any depth takes constant stack.
+    ~ObjectNode() override;
     void addOrEditChild(std::string key, std::shared_ptr<Node> child);
-    std::map<std::string, std::shared_ptr<Node>>& getChildren();
+    Children& getChildren();
+    const Children& getChildren() const;
     std::string pretty() const override;
     std::ostream& dump(std::ostream& os) const override;
 };
@@ -116,10 +141,10 @@ class ValueNode : public Node {
 private:
     T value_;
 public:
-    ValueNode(T value) : Node(ValueType::get<T>()), value_(value) { }
+    ValueNode(T value) : Node(ValueType::get<T>()), value_(std::move(value)) { }
     T value() const { return value_; }
     ValueNode& operator=(T value) {
-        value_ = value;
+        value_ = std::move(value);
         return *this;
     }
     std::string pretty() const override {
@@ -132,18 +157,172 @@ public:
     }
 };
 
+// Tags text that lives in the caller's buffer rather than in the node.
+struct Borrowed { };
+
+// Numbers parsed with ParseOptions::rawNumbers keep their lexeme, decode it
+// on every read and dump it unchanged.
+template <is_json_number_type T>
+class ValueNode<T> : public Node {
+private:
+    T value_{};
+    std::string owned;
+    // Empty unless the number is raw.
+    std::string_view lexeme_;
+public:
+    ValueNode(T value) : Node(ValueType::get<T>()), value_(value) { }
+    ValueNode(std::string lexeme) : Node(ValueType::get<T>()), owned(std::move(lexeme)), lexeme_(owned) { }
+    ValueNode(std::string_view lexeme, Borrowed) : Node(ValueType::get<T>()), lexeme_(lexeme) { }
+    ValueNode(const ValueNode&) = delete;
+    ValueNode& operator=(const ValueNode&) = delete;
+    // Throws WrongObjectType if a raw number does not fit T.
+    T value() const {
+        if (lexeme_.empty()) return value_;
+        T value{};
+        auto [stop, error] = std::from_chars(lexeme_.data(), lexeme_.data() + lexeme_.size(), value);
+        if (error != std::errc() || stop != lexeme_.data() + lexeme_.size()) throw WrongObjectType::OutOfRange();
+        return value;
+    }
+    std::string_view lexeme() const { return lexeme_; }
+    ValueNode& operator=(T value) {
+        value_ = value;
+        owned.clear();
+        lexeme_ = {};
+        return *this;
+    }
+    std::string pretty() const override {
+        std::ostringstream os;
+        dump(os);
+        return os.str();
+    }
+    std::ostream& dump(std::ostream& os) const override {
+        if (lexeme_.empty()) return os << value_;
+        return os.write(lexeme_.data(), lexeme_.size());
+    }
+};
+
+// Strings own their text unless parsed in situ, in which case they point into
+// the caller's buffer, or stored by reference (ParseOptions::referenceStrings),
+// in which case they point into a source such as a mapped file and keep it
+// alive.
+template <>
+class ValueNode<std::string> : public Node {
+private:
+    std::string owned;
+    std::string_view text;
+    std::shared_ptr<const void> source;
+public:
+    ValueNode(std::string value) : Node(ValueType::Concrete::String), owned(std::move(value)), text(owned) { }
+    ValueNode(std::string_view value, Borrowed) : Node(ValueType::Concrete::String), text(value) { }
+    ValueNode(std::string_view value, std::shared_ptr<const void> source)
+        : Node(ValueType::Concrete::String), text(value), source(std::move(source)) { }
+    ValueNode(const ValueNode&) = delete;
+    ValueNode& operator=(const ValueNode&) = delete;
+    std::string value() const { return std::string(text); }
+    std::string_view view() const { return text; }
+    ValueNode& operator=(std::string value) {
+        owned = std::move(value);
+        text = owned;
+        source.reset();
+        return *this;
+    }
+    std::string pretty() const override;
+    std::ostream& dump(std::ostream& os) const override;
+};
+
 class ListNode : public Node {
+public:
+    typedef std::vector<std::shared_ptr<Node>, ArenaAllocator<std::shared_ptr<Node>>> Children;
 private:
-    std::vector<std::shared_ptr<Node>> children;
+    Children children;
 public:
     ListNode();
+    explicit ListNode(ArenaAllocator<Node> allocator);
+    ~ListNode() override;
     void addChild(std::shared_ptr<Node> child);
-    std::vector<std::shared_ptr<Node>>& getChildren();
+    void reserve(size_t size);
+    Children& getChildren();
+    const Children& getChildren() const;
     std::string pretty() const override;
     std::ostream& dump(std::ostream& os) const override;
     std::shared_ptr<Node> get(size_t idx);
 };
 
+// Reads the value of a leaf after a single switch on its type tag. Int
+// widens to float; any other mismatch yields nullopt.
+template <is_json_leaf_type T>
+std::optional<T> nodeValue(const Node& node) {
+    switch (node.type()) {
+        case ValueType::Concrete::Int:
+            if constexpr (std::same_as<T, int> || std::same_as<T, float>)
+                return static_cast<T>(static_cast<const ValueNode<int>&>(node).value());
+            break;
+        case ValueType::Concrete::Float:
+            if constexpr (std::same_as<T, float>)
+                return static_cast<const ValueNode<float>&>(node).value();
+            break;
+        case ValueType::Concrete::String:
+            if constexpr (std::same_as<T, std::string>)
+                return static_cast<const ValueNode<std::string>&>(node).value();
+            break;
+        case ValueType::Concrete::Bool:
+            if constexpr (std::same_as<T, bool>)
+                return static_cast<const ValueNode<bool>&>(node).value();
+            break;
+        default:
+            break;
+    }
+    return std::nullopt;
+}
+
+// Converts to T, throwing WrongObjectType if the value is beyond its range.
+template <typename T>
+T narrowNumber(double value) {
+    if constexpr (std::integral<T>) {
+        if (!(value >= static_cast<double>(std::numeric_limits<T>::min())
+              && value < static_cast<double>(std::numeric_limits<T>::max()) + 1))
+            throw WrongObjectType::OutOfRange();
+    }
+    return static_cast<T>(value);
+}
+
+// Reads any number as T. Raw lexemes are decoded straight into T, so 64-bit
+// integers and doubles keep their full precision. Throws WrongObjectType if
+// the number is beyond T's range.
+template <typename T>
+requires (std::is_arithmetic_v<T> && !std::same_as<T, bool>)
+std::optional<T> numberValue(const Node& node) {
+    std::string_view lexeme;
+    switch (node.type()) {
+        case ValueType::Concrete::Int:
+            lexeme = static_cast<const ValueNode<int>&>(node).lexeme();
+            if (lexeme.empty()) return narrowNumber<T>(static_cast<const ValueNode<int>&>(node).value());
+            break;
+        case ValueType::Concrete::Float:
+            lexeme = static_cast<const ValueNode<float>&>(node).lexeme();
+            if (lexeme.empty()) return narrowNumber<T>(static_cast<const ValueNode<float>&>(node).value());
+            break;
+        default:
+            return std::nullopt;
+    }
+    const char* end = lexeme.data() + lexeme.size();
+    T value{};
+    auto [stop, error] = std::from_chars(lexeme.data(), end, value);
+    if (error == std::errc() && stop == end) return value;
+    if (error == std::errc::result_out_of_range) throw WrongObjectType::OutOfRange();
+    // A fraction or exponent read into an integer.
+    double approximate = 0;
+    if (std::from_chars(lexeme.data(), end, approximate).ec != std::errc()) throw WrongObjectType::OutOfRange();
+    return narrowNumber<T>(approximate);
+}
+
+// Throws WrongObjectType when the node does not hold a T.
+template <is_json_leaf_type T>
+T checkedValue(const Node& node) {
+    if (auto value = nodeValue<T>(node)) return *std::move(value);
+    throw WrongObjectType::NotLeaf<T>();
+}
+
 template <typename T>
 concept is_json_container_type = type_is_one_of<T, ListNode, ObjectNode>;
 
@@ -153,65 +332,293 @@ concept is_json_container_or_base_type = type_is_one_of<T, ListNode, ObjectNode,
 template <typename T>
 concept is_json_valid_type = type_is_one_of<T, ListNode, ObjectNode, NullNode, Node>;
 
-// Parsing
-static std::shared_ptr<Node>        parse(std::string& json);
-static std::shared_ptr<Node>        parseRecursively(std::string& json, size_t& index);
-static std::shared_ptr<ObjectNode>  parseObject(std::string& json, size_t& index);
-static std::shared_ptr<ListNode>    parseList(std::string& json, size_t& index);
-static std::shared_ptr<Node>        parseValue(std::string& json, size_t& index);
+// FNV-1a over the key's bytes, shared by the profiler's shape hashes and the
+// NDJSON cardinality sketches.
+constexpr uint64_t hashKey(std::string_view name) {
+    uint64_t h = 0xcbf29ce484222325;
+    for (char ch : name) h = (h ^ static_cast<unsigned char>(ch)) * 0x100000001b3;
+    return h;
+}
+
+// Handle for a key that is looked up repeatedly, e.g.
+// json[json::Key<"user_id">{}] or, with a constant, json[json::key("user_id")].
+// Its length is known up front, so no strlen or std::string is involved;
+// objects are ordered maps, so lookups still compare the key's bytes.
+struct KeyRef {
+    std::string_view name;
+};
+
+constexpr KeyRef key(std::string_view name) {
+    return KeyRef{name};
+}
+
+template <size_t N>
+struct FixedString {
+    char data[N];
+    constexpr FixedString(const char (&str)[N]) {
+        for (size_t i = 0; i < N; ++i) data[i] = str[i];
+    }
+    constexpr std::string_view view() const { return std::string_view(data, N - 1); }
+};
+
+template <FixedString Name>
+struct Key {
+    static constexpr std::string_view name = Name.view();
+    constexpr operator KeyRef() const { return KeyRef{name}; }
+};
+
+struct ParseOptions {
+    // Keep numbers as written: they are decoded only when read, and dump()
+    // re-emits them unchanged. In situ, the lexeme stays in the buffer.
+    bool rawNumbers = false;
+    // Store strings of at least this many bytes that need no unescaping as a
+    // reference to their bytes in the input instead of a copy; 0 copies all.
+    // fromFile() then maps the file rather than reading it, and the nodes
+    // keep the mapping alive. With parse() the input must outlive the
+    // document, as in situ.
+    size_t referenceStrings = 0;
+    // Where to place nodes, containers' storage and string text instead of
+    // allocating each on its own. Nodes keep the arena alive. Keys too long
+    // for std::string's inline buffer still come from the heap.
+    std::shared_ptr<Arena> arena;
+};
 
 class Json {
 public:
+    class Items;
+    class Elements;
+    // Non-owning handle to a slot of the tree; it keeps nothing alive. A view
+    // of the root lasts while its Json is not destroyed, moved from or
+    // reassigned. A view of a member or element lasts while its parent stays in
+    // the tree, and for elements, while that list is not resized. So a view of
+    // a temporary, such as parse(text)["a"], is only usable within the same
+    // full expression.
     class View {
-    public:
-        typedef std::shared_ptr<std::shared_ptr<Node>> ppNode;
     private:
-        ppNode node;
+        std::shared_ptr<Node>* slot;
+        // The document's arena, where adopted trees are copied to.
+        const std::shared_ptr<Arena>* arena;
     public:
-        template <is_json_valid_type T>
-        View(std::shared_ptr<T>& node) {
-            this->node = std::make_shared<std::shared_ptr<Node>>(node);
-        }
-        View operator[] (std::string key);
+        View(std::shared_ptr<Node>& slot, const std::shared_ptr<Arena>* arena = nullptr) : slot(&slot), arena(arena) { }
+        // Missing keys are inserted as null.
+        View operator[] (std::string_view key);
+        View operator[] (KeyRef key) { return (*this)[key.name]; }
         View operator[] (size_t idx);
         template <is_json_leaf_type T>
         View operator=(T value) {
-            *std::static_pointer_cast<ValueNode<T>>(*node) = value;
+            if ((*slot)->type() == ValueType::get<T>())
+                *std::static_pointer_cast<ValueNode<T>>(*slot) = value;
+            else
+                *slot = std::make_shared<ValueNode<T>>(value);
             return *this;
         }
         template <is_json_leaf_type T>
-        T as() {
-            return std::static_pointer_cast<ValueNode<T>>(*node)->value();
+        T as() const { return checkedValue<T>(**slot); }
+        template <is_json_leaf_type T>
+        T get() const { return checkedValue<T>(**slot); }
+        template <is_json_leaf_type T>
+        std::optional<T> get_if() const { return nodeValue<T>(**slot); }
+        template <typename T>
+        T number() const {
+            if (auto value = numberValue<T>(**slot)) return *value;
+            throw WrongObjectType::NotNumber();
         }
+        ValueType::Concrete type() const { return (*slot)->type(); }
+        const Node& node() const { return **slot; }
+        Items items() const;
+        Elements elements() const;
+        // Elements [begin, end) of a list, without copying them. Bounds are
+        // clamped to the list, as in items[offset:offset + limit] paging.
+        Elements slice(size_t begin, size_t end) const;
+        Elements subspan(size_t offset, size_t count = std::dynamic_extent) const;
+        // Moves another document into this slot and leaves it null. Its
+        // nodes are linked in as they are when both documents use the same
+        // arena, or both the heap, and copied into this document's arena in
+        // one pass otherwise, so nothing here depends on where it came from.
+        View adopt(Json&& other);
+        std::ostream& dump(std::ostream& os) const;
+    };
+
+    // Ranges over the children of an object or a list, or a slice of one.
+    // Iterating allocates nothing and touches no reference counts.
+    class Items : public std::ranges::view_interface<Items> {
+    public:
+        class iterator {
+        private:
+            ObjectNode::Children::iterator it;
+            const std::shared_ptr<Arena>* arena = nullptr;
+        public:
+            using iterator_concept = std::bidirectional_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type = std::pair<std::string_view, View>;
+            using difference_type = std::ptrdiff_t;
+            iterator() = default;
+            iterator(ObjectNode::Children::iterator it, const std::shared_ptr<Arena>* arena) : it(it), arena(arena) { }
+            value_type operator*() const { return {it->first, View(it->second, arena)}; }
+            iterator& operator++() { ++it; return *this; }
+            iterator operator++(int) { iterator copy = *this; ++it; return copy; }
+            iterator& operator--() { --it; return *this; }
+            iterator operator--(int) { iterator copy = *this; --it; return copy; }
+            bool operator==(const iterator& other) const = default;
+        };
+    private:
+        ObjectNode* object = nullptr;
+        const std::shared_ptr<Arena>* arena = nullptr;
+    public:
+        Items() = default;
+        explicit Items(ObjectNode& object, const std::shared_ptr<Arena>* arena = nullptr) : object(&object), arena(arena) { }
+        iterator begin() const { return iterator(object->getChildren().begin(), arena); }
+        iterator end() const { return iterator(object->getChildren().end(), arena); }
+        size_t size() const { return object->getChildren().size(); }
+    };
+
+    class Elements : public std::ranges::view_interface<Elements> {
+    public:
+        class iterator {
+        private:
+            ListNode::Children::iterator it;
+            const std::shared_ptr<Arena>* arena = nullptr;
+        public:
+            using iterator_concept = std::bidirectional_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type = View;
+            using difference_type = std::ptrdiff_t;
+            iterator() = default;
+            iterator(ListNode::Children::iterator it, const std::shared_ptr<Arena>* arena) : it(it), arena(arena) { }
+            View operator*() const { return View(*it, arena); }
+            iterator& operator++() { ++it; return *this; }
+            iterator operator++(int) { iterator copy = *this; ++it; return copy; }
+            iterator& operator--() { --it; return *this; }
+            iterator operator--(int) { iterator copy = *this; --it; return copy; }
+            bool operator==(const iterator& other) const = default;
+        };
+    private:
+        ListNode::Children::iterator first;
+        ListNode::Children::iterator last;
+        const std::shared_ptr<Arena>* arena = nullptr;
+    public:
+        Elements() = default;
+        explicit Elements(ListNode& list, const std::shared_ptr<Arena>* arena = nullptr)
+            : first(list.getChildren().begin()), last(list.getChildren().end()), arena(arena) { }
+        Elements(ListNode::Children::iterator first, ListNode::Children::iterator last,
+                 const std::shared_ptr<Arena>* arena = nullptr) : first(first), last(last), arena(arena) { }
+        iterator begin() const { return iterator(first, arena); }
+        iterator end() const { return iterator(last, arena); }
+        size_t size() const { return last - first; }
+        // Writes the elements as a JSON list.
+        std::ostream& dump(std::ostream& os) const;
     };
 private:
     std::shared_ptr<Node> root;
-    Json(std::shared_ptr<Node> root);
+    // Where the parser placed the nodes; null for the heap.
+    std::shared_ptr<Arena> arena;
+    Json(std::shared_ptr<Node> root, std::shared_ptr<Arena> arena = nullptr);
+    template <typename T>
+    friend Json to_json(T&& value);
+    friend void reclaimInBackground(Json&& document);
 public:
     Json(ValueType::Concrete type);
     Json(std::initializer_list<std::pair<std::string, Json>> list);
     template <is_json_leaf_type T>
     Json(T value) : root(std::make_shared<ValueNode<T>>(value)) { }
     Json(const char* value);
-    static Json fromFile(const std::string filename);
+    // Reads the file into a padded buffer, or maps it when strings are
+    // stored by reference.
+    static Json fromFile(const std::string filename, ParseOptions options = {});
+    // Throw Malformed on invalid input. Padded input is scanned in whole
+    // blocks without bounds checks; other input takes a checked path.
+    static Json parse(std::string_view json, ParseOptions options = {});
+    static Json parse(PaddedBuffer json, ParseOptions options = {});
+    // Unescapes strings inside `buffer` and points the string nodes at them,
+    // so no string is copied. The buffer is overwritten and must outlive the
+    // document and every string_view taken from it.
+    static Json parseInSitu(std::span<char> buffer, ParseOptions options = {});
+    static Json parseInSitu(PaddedBuffer buffer, ParseOptions options = {});
     static Json array(std::initializer_list<Json>& list);
+    // Detaches the value at a JSON pointer and returns it as a document of
+    // its own; no node is copied. The empty pointer takes the whole document
+    // and leaves null behind. Throws WrongObjectType if the path runs through
+    // a scalar and std::out_of_range if there is no such value.
+    Json extract(std::string_view pointer);
+    // Copies the document in one pass into `arena`, or onto the heap without
+    // one, so that it no longer depends on where it was parsed.
+    Json relocate(std::shared_ptr<Arena> arena = nullptr) const;
     std::ostream& dump(std::ostream& os) const;
+    const Node& node() const;
 public:
-    View operator[] (std::string key);
+    View operator[] (std::string_view key);
+    View operator[] (KeyRef key) { return (*this)[key.name]; }
     View operator[] (size_t idx);
     template <is_json_leaf_type T>
-    T as() {
-        return std::static_pointer_cast<ValueNode<T>>(root)->value();
+    T as() const { return checkedValue<T>(*root); }
+    template <is_json_leaf_type T>
+    T get() const { return checkedValue<T>(*root); }
+    template <is_json_leaf_type T>
+    std::optional<T> get_if() const { return nodeValue<T>(*root); }
+    template <typename T>
+    T number() const {
+        if (auto value = numberValue<T>(*root)) return *value;
+        throw WrongObjectType::NotNumber();
     }
+    Items items();
+    Elements elements();
+    Elements slice(size_t begin, size_t end);
+    Elements subspan(size_t offset, size_t count = std::dynamic_extent);
 public:
     friend std::ostream& operator<<(std::ostream& os, const Json& json) {
         return json.dump(os);
     }
 };
 
-Json fromFile(const std::string filename);
+Json fromFile(const std::string filename, ParseOptions options = {});
+Json parse(std::string_view json, ParseOptions options = {});
+Json parse(PaddedBuffer json, ParseOptions options = {});
+Json parseInSitu(std::span<char> buffer, ParseOptions options = {});
+Json parseInSitu(PaddedBuffer buffer, ParseOptions options = {});
 Json array(std::initializer_list<Json> list);
 
+// Parses into a buffer of N bytes inside this object, e.g. on the caller's
+// stack, taking heap blocks only once it is full. A small message is then
+// parsed and read without touching the allocator. The document, and anything
+// taken from it, must not outlive this object.
+template <size_t N = 4096>
+class SmallDocument {
+private:
+    alignas(std::max_align_t) std::byte buffer[N];
+    Arena arena;
+    Json document;
+
+    ParseOptions inArena(ParseOptions options) {
+        // Non-owning: this object, not the nodes, keeps the arena alive.
+        options.arena = std::shared_ptr<Arena>(std::shared_ptr<Arena>(), &arena);
+        return options;
+    }
+public:
+    // Throws Malformed on invalid input.
+    explicit SmallDocument(std::string_view json, ParseOptions options = {})
+        : arena(std::span<std::byte>(buffer, N)), document(Json::parse(json, inArena(std::move(options)))) { }
+    SmallDocument(const SmallDocument&) = delete;
+    SmallDocument& operator=(const SmallDocument&) = delete;
+    Json& operator*() { return document; }
+    Json* operator->() { return &document; }
+    // Whether the whole document fit in the buffer.
+    bool fits() const { return arena.capacity() == 0; }
+};
+
+// Hands the document to a background thread that destroys it, so dropping
+// even a huge tree costs the caller a queue push. Subtrees still referenced
+// elsewhere are left alone. Pending documents are destroyed at exit.
+void reclaimInBackground(Json&& document);
+
+// Writes str as a quoted JSON string, escaping quotes, backslashes and control characters.
+std::ostream& writeEscaped(std::ostream& os, std::string_view str);
+// The same without the quotes, for a string written in pieces.
+std::ostream& writeEscapedRun(std::ostream& os, std::string_view str);
+
+// Splits a JSON pointer (RFC 6901) into its unescaped reference tokens.
+// Throws std::runtime_error unless it is empty or starts with '/'.
+std::vector<std::string> pointerTokens(std::string_view pointer);
+
 };
 
 #endif
@@ -0,0 +1,27 @@
+#ifndef JSON_MAPPED_HPP
+#define JSON_MAPPED_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace json {
+
+// Read-only mapping of a whole file. Pages are read on first access and,
+// being backed by the file, can be dropped again under memory pressure.
+class MappedFile {
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+public:
+    // Throws std::runtime_error if the file cannot be opened or mapped.
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    std::string_view view() const { return std::string_view(data_, size_); }
+};
+
+};
+
+#endif
@@ -0,0 +1,718 @@
+#include "ndjson.hpp"
+#include "json.hpp"
+#include "sax.hpp"
+#include "stream.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
+
+namespace json {
+
+namespace {
+
+constexpr size_t chunkSize = 1 << 22;
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+const char* skipSpace(const char* p, const char* end) {
+    while (p != end && isSpace(*p)) ++p;
+    return p;
+}
+
+// Given the opening quote, returns the position past the closing one.
+const char* skipString(const char* p, const char* end) {
+    ++p;
+    for (;;) {
+        auto q = static_cast<const char*>(std::memchr(p, '"', end - p));
+        if (!q) throw Malformed();
+        const char* b = q;
+        while (b != p && b[-1] == '\\') --b;
+        if ((q - b) % 2 == 0) return q + 1;
+        p = q + 1;
+    }
+}
+
+// Returns the position past the value starting at p.
+const char* skipValue(const char* p, const char* end) {
+    if (p == end) throw Malformed();
+    if (*p == '"') return skipString(p, end);
+    if (*p != '{' && *p != '[') {
+        const char* q = p;
+        while (q != end && !isSpace(*q) && *q != ',' && *q != '}' && *q != ']' && *q != ':') ++q;
+        if (q == p) throw Malformed();
+        return q;
+    }
+    size_t depth = 0;
+    while (p != end) {
+        switch (*p) {
+            case '"':
+                p = skipString(p, end);
+                continue;
+            case '{':
+            case '[':
+                ++depth;
+                break;
+            case '}':
+            case ']':
+                if (--depth == 0) return p + 1;
+                break;
+        }
+        ++p;
+    }
+    throw Malformed();
+}
+
+// The contents of a quoted string; unescaped into `scratch` only if needed.
+std::string_view unquote(std::string_view quoted, std::string& scratch) {
+    std::string_view raw = quoted.substr(1, quoted.size() - 2);
+    if (raw.find('\\') == std::string_view::npos) return raw;
+    struct Capture : sax::Handler {
+        std::string& out;
+        Capture(std::string& out) : out(out) { }
+        void string(std::string_view value) override { out.assign(value); }
+    } capture(scratch);
+    sax::parse(quoted, capture);
+    return scratch;
+}
+
+// The unescaped key at p, which points at its opening quote; `next` is set
+// past the closing quote.
+std::string_view readKey(const char* p, const char* end, const char*& next, std::string& scratch) {
+    if (p == end || *p != '"') throw Malformed();
+    next = skipString(p, end);
+    return unquote(std::string_view(p, next - p), scratch);
+}
+
+// Calls `member(key, value)` for each member of the object starting at p and
+// returns the position past it; `value` spans the member's raw value.
+template <typename Member>
+const char* forEachMember(const char* p, const char* end, Member member) {
+    std::string scratch;
+    if (p == end || *p != '{') throw Malformed();
+    p = skipSpace(p + 1, end);
+    if (p != end && *p == '}') return p + 1;
+    for (;;) {
+        const char* next;
+        std::string_view key = readKey(p, end, next, scratch);
+        p = skipSpace(next, end);
+        if (p == end || *p != ':') throw Malformed();
+        p = skipSpace(p + 1, end);
+        const char* valueEnd = skipValue(p, end);
+        member(key, std::string_view(p, valueEnd - p));
+        p = skipSpace(valueEnd, end);
+        if (p == end) throw Malformed();
+        if (*p == '}') return p + 1;
+        if (*p != ',') throw Malformed();
+        p = skipSpace(p + 1, end);
+    }
+}
+
+// Calls `record(line)` for each non-blank line of a chunk.
+template <typename Record>
+void forEachRecord(std::string_view chunk, Record record) {
+    while (!chunk.empty()) {
+        auto newline = static_cast<const char*>(std::memchr(chunk.data(), '\n', chunk.size()));
+        size_t length = newline ? newline - chunk.data() : chunk.size();
+        std::string_view line = chunk.substr(0, length);
+        chunk.remove_prefix(newline ? length + 1 : length);
+        const char* begin = skipSpace(line.data(), line.data() + line.size());
+        if (begin != line.data() + line.size()) record(std::string_view(begin, line.data() + line.size() - begin));
+    }
+}
+
+// A newline-aligned piece of input, either borrowed or read from a stream.
+struct Chunk {
+    std::string owned;
+    std::string_view borrowed;
+    std::string_view text() const { return owned.empty() ? borrowed : std::string_view(owned); }
+};
+
+class StreamChunks {
+private:
+    std::istream& in;
+    size_t size;
+    std::string carry;
+public:
+    StreamChunks(std::istream& in, size_t size = chunkSize) : in(in), size(size) { }
+    std::optional<Chunk> operator()() {
+        Chunk chunk;
+        chunk.owned = std::move(carry);
+        carry.clear();
+        while (in) {
+            size_t start = chunk.owned.size();
+            chunk.owned.resize(start + size);
+            in.read(chunk.owned.data() + start, size);
+            chunk.owned.resize(start + in.gcount());
+            size_t newline = chunk.owned.rfind('\n');
+            if (newline != std::string::npos && newline >= start) {
+                carry.assign(chunk.owned, newline + 1);
+                chunk.owned.resize(newline + 1);
+                return chunk;
+            }
+        }
+        if (chunk.owned.empty()) return std::nullopt;
+        return chunk;
+    }
+};
+
+class ViewChunks {
+private:
+    std::string_view rest;
+public:
+    ViewChunks(std::string_view in) : rest(in) { }
+    std::optional<Chunk> operator()() {
+        if (rest.empty()) return std::nullopt;
+        size_t length = rest.size();
+        if (length > chunkSize) {
+            size_t newline = rest.find('\n', chunkSize);
+            if (newline != std::string_view::npos) length = newline + 1;
+        }
+        Chunk chunk;
+        chunk.borrowed = rest.substr(0, length);
+        rest.remove_prefix(length);
+        return chunk;
+    }
+};
+
+unsigned threadCount(unsigned threads) {
+    if (threads) return threads;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Runs `work` on each chunk with up to `threads` chunks in flight and passes
+// the results to `done` in input order.
+template <typename Chunks, typename Work, typename Done>
+void inParallel(Chunks next, unsigned threads, Work work, Done done) {
+    using Result = decltype(work(std::string_view()));
+    threads = threadCount(threads);
+    std::deque<std::future<Result>> pending;
+    while (auto chunk = next()) {
+        if (pending.size() == threads) {
+            done(pending.front().get());
+            pending.pop_front();
+        }
+        pending.push_back(std::async(std::launch::async, [chunk = std::move(*chunk), &work] {
+            return work(chunk.text());
+        }));
+    }
+    for (auto& result : pending) done(result.get());
+}
+
+// The selected pointers as a tree of member names.
+struct Field {
+    std::string name;
+    // `"name":` as written to the output.
+    std::string prefix;
+    std::vector<Field> children;
+    // Selected as a whole; children are ignored.
+    bool leaf = false;
+    // Index into a record's values, for leaves.
+    size_t slot = 0;
+};
+
+class Projection {
+private:
+    std::vector<Field> fields;
+    size_t slots = 0;
+
+    static void number(std::vector<Field>& fields, size_t& slots) {
+        for (auto& field : fields) {
+            if (field.leaf) field.slot = slots++;
+            else number(field.children, slots);
+        }
+    }
+    // Returns the position past the object.
+    const char* collect(std::string_view object, const std::vector<Field>& fields, std::vector<std::string_view>& values) const {
+        return forEachMember(object.data(), object.data() + object.size(), [&](std::string_view key, std::string_view value) {
+            for (const auto& field : fields) {
+                if (field.name != key) continue;
+                if (field.leaf) values[field.slot] = value;
+                else if (value.front() == '{') collect(value, field.children, values);
+            }
+        });
+    }
+    // Returns whether anything was written.
+    bool write(const std::vector<Field>& fields, const std::vector<std::string_view>& values, std::string& out) const {
+        out.push_back('{');
+        bool any = false;
+        for (const auto& field : fields) {
+            size_t mark = out.size();
+            if (any) out.push_back(',');
+            out += field.prefix;
+            bool wrote;
+            if (field.leaf) {
+                std::string_view value = values[field.slot];
+                wrote = !value.empty();
+                if (wrote && (value.front() == '{' || value.front() == '[')) out += minify(value);
+                else out += value;
+            } else {
+                wrote = write(field.children, values, out);
+            }
+            if (wrote) any = true;
+            else out.resize(mark);
+        }
+        out.push_back('}');
+        return any;
+    }
+public:
+    Projection(const std::vector<std::string>& pointers) {
+        for (const auto& pointer : pointers) {
+            std::vector<Field>* level = &fields;
+            auto tokens = pointerTokens(pointer);
+            if (tokens.empty()) throw std::runtime_error("Cannot project the whole record.");
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                auto it = std::find_if(level->begin(), level->end(), [&](const Field& f) { return f.name == tokens[i]; });
+                if (it == level->end()) {
+                    std::ostringstream prefix;
+                    writeEscaped(prefix, tokens[i]) << ':';
+                    level->push_back(Field{tokens[i], prefix.str(), {}, false, 0});
+                    it = level->end() - 1;
+                }
+                if (it->leaf) break;
+                if (i + 1 == tokens.size()) {
+                    it->leaf = true;
+                    it->children.clear();
+                }
+                level = &it->children;
+            }
+        }
+        number(fields, slots);
+    }
+    void record(std::string_view record, std::string& out) const {
+        std::vector<std::string_view> values(slots);
+        const char* end = record.data() + record.size();
+        if (skipSpace(collect(record, fields, values), end) != end) throw Malformed();
+        write(fields, values, out);
+        out.push_back('\n');
+    }
+};
+
+void appendToken(std::string& path, std::string_view token) {
+    path.push_back('/');
+    for (char ch : token) {
+        if (ch == '~') path += "~0";
+        else if (ch == '/') path += "~1";
+        else path.push_back(ch);
+    }
+}
+
+// What a number beyond the range of a double stands for: an infinity when its
+// first significant digit is above the decimal point, a zero otherwise.
+double saturate(std::string_view lexeme) {
+    bool negative = lexeme.front() == '-';
+    size_t mantissa = std::min(lexeme.find_first_of("eE"), lexeme.size());
+    size_t point = std::min(lexeme.find('.'), mantissa);
+    size_t first = lexeme.find_first_of("123456789");
+    long magnitude = first < point ? long(point - first) : -long(first - point);
+    if (first < mantissa && mantissa < lexeme.size()) {
+        const char* begin = lexeme.data() + mantissa + 1;
+        if (*begin == '+') ++begin;
+        long exponent = 0;
+        if (std::from_chars(begin, lexeme.data() + lexeme.size(), exponent).ec != std::errc()) {
+            exponent = *begin == '-' ? std::numeric_limits<long>::min() / 2 : std::numeric_limits<long>::max() / 2;
+        }
+        magnitude += exponent;
+    }
+    double limit = first < mantissa && magnitude > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+    return negative ? -limit : limit;
+}
+
+class SchemaBuilder : public sax::Handler {
+private:
+    using Concrete = ValueType::Concrete;
+    Schema& result;
+    std::string path;
+    // Length of `path` for each open container, and whether it is an object.
+    std::vector<std::pair<size_t, bool>> frames;
+
+    FieldSchema& value(Concrete type) {
+        FieldSchema& field = result.fields[path];
+        ++field.values;
+        ++field.types[static_cast<size_t>(type)];
+        return field;
+    }
+    void finishValue() {
+        if (!frames.empty() && frames.back().second) path.resize(frames.back().first);
+    }
+    void begin(Concrete type) {
+        value(type);
+        frames.emplace_back(path.size(), type == Concrete::Object);
+        if (type == Concrete::List) path += "/*";
+    }
+    void end() {
+        path.resize(frames.back().first);
+        frames.pop_back();
+        finishValue();
+    }
+public:
+    SchemaBuilder(Schema& result) : result(result) { }
+    void null() override {
+        value(Concrete::Null);
+        finishValue();
+    }
+    void boolean(bool) override {
+        value(Concrete::Bool);
+        finishValue();
+    }
+    void number(std::string_view lexeme) override {
+        bool isFloat = lexeme.find_first_of(".eE") != std::string_view::npos;
+        FieldSchema& field = value(isFloat ? Concrete::Float : Concrete::Int);
+        double number = 0;
+        if (std::from_chars(lexeme.data(), lexeme.data() + lexeme.size(), number).ec == std::errc::result_out_of_range)
+            number = saturate(lexeme);
+        field.min = std::min(field.min, number);
+        field.max = std::max(field.max, number);
+        finishValue();
+    }
+    void string(std::string_view value) override {
+        this->value(Concrete::String).strings.add(value);
+        finishValue();
+    }
+    void key(std::string_view key) override { appendToken(path, key); }
+    void beginObject() override { begin(Concrete::Object); }
+    void endObject() override { end(); }
+    void beginList() override { begin(Concrete::List); }
+    void endList() override { end(); }
+    void endDocument() override { ++result.records; }
+};
+
+template <typename Chunks>
+Schema inferChunks(Chunks chunks, unsigned threads) {
+    Schema schema;
+    inParallel(std::move(chunks), threads, [](std::string_view chunk) {
+        Schema partial;
+        SchemaBuilder builder(partial);
+        sax::parse(chunk, builder, sax::Options{.sequence = true});
+        return partial;
+    }, [&](const Schema& partial) { schema.merge(partial); });
+    return schema;
+}
+
+// The raw value at the tokens' path, or an empty view.
+std::string_view lookup(std::string_view record, const std::vector<std::string>& tokens, size_t depth = 0) {
+    std::string_view found;
+    const char* end = record.data() + record.size();
+    const char* after = forEachMember(record.data(), end, [&](std::string_view key, std::string_view value) {
+        if (key != tokens[depth]) return;
+        if (depth + 1 == tokens.size()) found = value;
+        else if (value.front() == '{') found = lookup(value, tokens, depth + 1);
+        else found = {};
+    });
+    if (depth == 0 && skipSpace(after, end) != end) throw Malformed();
+    return found;
+}
+
+struct SortKey {
+    // Missing, null, false, true, number, string, other.
+    int rank = 0;
+    double number = 0;
+    std::string text;
+    // The value as written.
+    std::string_view raw;
+
+    SortKey(std::string_view record, const std::vector<std::string>& tokens) : raw(lookup(record, tokens)) {
+        if (raw.empty()) return;
+        switch (raw.front()) {
+            case 'n': rank = 1; break;
+            case 'f': rank = 2; break;
+            case 't': rank = 3; break;
+            case '"': {
+                rank = 5;
+                std::string scratch;
+                text = unquote(raw, scratch);
+                break;
+            }
+            case '{':
+            case '[':
+                rank = 6;
+                text = raw;
+                break;
+            default: {
+                rank = 4;
+                auto [end, error] = std::from_chars(raw.data(), raw.data() + raw.size(), number);
+                if (end != raw.data() + raw.size()) throw Malformed();
+                if (error == std::errc::result_out_of_range) number = saturate(raw);
+                else if (error != std::errc()) throw Malformed();
+            }
+        }
+    }
+    friend bool operator<(const SortKey& a, const SortKey& b) {
+        if (a.rank != b.rank) return a.rank < b.rank;
+        if (a.rank == 4) return a.number < b.number;
+        return a.text < b.text;
+    }
+    friend bool operator==(const SortKey& a, const SortKey& b) { return !(a < b) && !(b < a); }
+};
+
+// Sorts the records of a chunk, one per line.
+std::string sortRun(std::string_view chunk, const std::vector<std::string>& tokens) {
+    std::vector<std::pair<SortKey, std::string_view>> records;
+    forEachRecord(chunk, [&](std::string_view record) { records.emplace_back(SortKey(record, tokens), record); });
+    std::stable_sort(records.begin(), records.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::string run;
+    run.reserve(chunk.size());
+    for (const auto& [key, record] : records) {
+        run += record;
+        run.push_back('\n');
+    }
+    return run;
+}
+
+class TempFile {
+private:
+    std::filesystem::path path_;
+public:
+    explicit TempFile(const std::string& directory) {
+        static std::atomic<unsigned> counter = 0;
+        std::filesystem::path base = directory.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(directory);
+        path_ = base / ("json-sort-" + std::to_string(getpid()) + "-" + std::to_string(counter++) + ".ndjson");
+    }
+    ~TempFile() {
+        std::error_code ignored;
+        std::filesystem::remove(path_, ignored);
+    }
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+    const std::filesystem::path& path() const { return path_; }
+};
+
+// Calls `emit(key, record)` for the records of sorted run files in order;
+// equal keys come from the earlier file first.
+template <typename Files, typename Emit>
+void mergeRuns(Files first, Files last, const std::vector<std::string>& tokens, Emit emit) {
+    struct Run {
+        std::ifstream in;
+        std::string line;
+        std::optional<SortKey> key;
+    };
+    std::vector<Run> runs(last - first);
+    auto advance = [&](Run& run) {
+        run.key.reset();
+        while (std::getline(run.in, run.line)) {
+            if (run.line.empty()) continue;
+            run.key.emplace(run.line, tokens);
+            return true;
+        }
+        return false;
+    };
+    // Min-heap of run indices; equal keys come from the earlier run first.
+    auto later = [&](size_t a, size_t b) {
+        if (*runs[b].key < *runs[a].key) return true;
+        if (*runs[a].key < *runs[b].key) return false;
+        return a > b;
+    };
+    std::vector<size_t> heap;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        runs[i].in.open(first[i]->path(), std::ios::binary);
+        if (advance(runs[i])) heap.push_back(i);
+    }
+    std::make_heap(heap.begin(), heap.end(), later);
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        Run& run = runs[heap.back()];
+        emit(*run.key, run.line);
+        if (advance(run)) std::push_heap(heap.begin(), heap.end(), later);
+        else heap.pop_back();
+    }
+}
+
+// Calls `emit(key, record)` for every record in sorted order. Runs are sorted
+// in parallel; all but a single run are spilled and merged.
+template <typename Emit>
+void sorted(std::istream& in, std::string_view pointer, const SortOptions& options, Emit emit) {
+    auto tokens = pointerTokens(pointer);
+    if (tokens.empty()) throw std::runtime_error("Cannot sort by the whole record.");
+    unsigned threads = threadCount(options.threads);
+    // Each task in flight holds its chunk and its sorted copy.
+    size_t runSize = std::max<size_t>(1, options.memory / (2 * (threads + 1)));
+
+    std::vector<std::unique_ptr<TempFile>> spilled;
+    std::optional<std::string> held;
+    auto spill = [&](const std::string& run) {
+        spilled.push_back(std::make_unique<TempFile>(options.directory));
+        std::ofstream file(spilled.back()->path(), std::ios::binary);
+        file.write(run.data(), run.size());
+        if (!file) throw std::runtime_error("Cannot write " + spilled.back()->path().string() + ".");
+    };
+    inParallel(StreamChunks(in, runSize), threads, [&](std::string_view chunk) {
+        return sortRun(chunk, tokens);
+    }, [&](std::string&& run) {
+        if (held) spill(*held);
+        held = std::move(run);
+    });
+
+    if (spilled.empty()) {
+        if (held) forEachRecord(*held, [&](std::string_view record) { emit(SortKey(record, tokens), record); });
+        return;
+    }
+    spill(*held);
+    held.reset();
+
+    // Merge passes write runs of at most fanIn inputs each until one pass
+    // can produce the output; each run's inputs are consecutive, which keeps
+    // equal keys in input order.
+    size_t fanIn = std::max<size_t>(2, options.fanIn);
+    while (spilled.size() > fanIn) {
+        std::vector<std::unique_ptr<TempFile>> merged;
+        for (size_t first = 0; first < spilled.size(); first += fanIn) {
+            size_t last = std::min(first + fanIn, spilled.size());
+            if (last - first == 1) {
+                merged.push_back(std::move(spilled[first]));
+                continue;
+            }
+            merged.push_back(std::make_unique<TempFile>(options.directory));
+            std::ofstream file(merged.back()->path(), std::ios::binary);
+            mergeRuns(spilled.begin() + first, spilled.begin() + last, tokens, [&](const SortKey&, std::string_view record) {
+                file.write(record.data(), record.size());
+                file.put('\n');
+            });
+            if (!file.flush()) throw std::runtime_error("Cannot write " + merged.back()->path().string() + ".");
+        }
+        spilled = std::move(merged);
+    }
+    mergeRuns(spilled.begin(), spilled.end(), tokens, emit);
+}
+
+}
+
+Aggregator::~Aggregator() { }
+
+void sortNdjson(std::istream& in, std::ostream& out, std::string_view pointer, SortOptions options) {
+    sorted(in, pointer, options, [&](const SortKey&, std::string_view record) {
+        out.write(record.data(), record.size());
+        out.put('\n');
+    });
+}
+
+void groupBy(std::istream& in, std::string_view pointer, Aggregator& aggregator, SortOptions options) {
+    std::optional<SortKey> current;
+    sorted(in, pointer, options, [&](const SortKey& key, std::string_view record) {
+        if (!current || !(*current == key)) {
+            if (current) aggregator.end();
+            current = key;
+            aggregator.begin(key.raw);
+        }
+        aggregator.record(record);
+    });
+    if (current) aggregator.end();
+}
+
+void HyperLogLog::add(std::string_view value) {
+    uint64_t h = hashKey(value);
+    // FNV alone leaves the high bits poorly mixed; finish as splitmix64 does.
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111eb;
+    h ^= h >> 31;
+    // The top 12 bits pick a register, the rest supply the leading zero run.
+    uint8_t rank = std::countl_zero((h << 12) | (uint64_t(1) << 11)) + 1;
+    uint8_t& slot = registers[h >> 52];
+    slot = std::max(slot, rank);
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    for (size_t i = 0; i < registers.size(); ++i) registers[i] = std::max(registers[i], other.registers[i]);
+}
+
+double HyperLogLog::estimate() const {
+    constexpr double m = 4096;
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t r : registers) {
+        sum += std::ldexp(1.0, -r);
+        zeros += r == 0;
+    }
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    // Linear counting is more accurate while many registers are still empty.
+    if (estimate <= 2.5 * m && zeros) return m * std::log(m / zeros);
+    return estimate;
+}
+
+void FieldSchema::merge(const FieldSchema& other) {
+    values += other.values;
+    for (size_t i = 0; i < types.size(); ++i) types[i] += other.types[i];
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    strings.merge(other.strings);
+}
+
+double Schema::presence(std::string_view path) const {
+    auto field = fields.find(path);
+    if (field == fields.end()) return 0;
+    size_t slash = path.rfind('/');
+    if (slash == std::string_view::npos || path.substr(slash) == "/*") return 1;
+    auto parent = fields.find(path.substr(0, slash));
+    size_t objects = parent == fields.end() ? 0 : parent->second.count(ValueType::Concrete::Object);
+    return objects ? static_cast<double>(field->second.values) / objects : 0;
+}
+
+void Schema::merge(const Schema& other) {
+    records += other.records;
+    for (const auto& [path, field] : other.fields) fields[path].merge(field);
+}
+
+std::ostream& Schema::dump(std::ostream& os) const {
+    using Concrete = ValueType::Concrete;
+    os << "{\"records\":" << records << ",\"fields\":{";
+    for (auto it = fields.begin(); it != fields.end(); ++it) {
+        const FieldSchema& field = it->second;
+        if (it != fields.begin()) os << ",";
+        writeEscaped(os, it->first) << ":{\"presence\":" << presence(it->first) << ",\"types\":{";
+        bool first = true;
+        for (auto type : {Concrete::Object, Concrete::List, Concrete::String, Concrete::Float, Concrete::Int, Concrete::Bool, Concrete::Null}) {
+            if (!field.count(type)) continue;
+            os << (first ? "" : ",") << '"' << ValueType::toString(type) << "\":" << field.count(type);
+            first = false;
+        }
+        os << "}";
+        if (field.min <= field.max) os << ",\"min\":" << field.min << ",\"max\":" << field.max;
+        if (field.count(Concrete::String)) os << ",\"distinct\":" << std::llround(field.strings.estimate());
+        os << "}";
+    }
+    return os << "}}";
+}
+
+void project(std::istream& in, const std::vector<std::string>& pointers, std::ostream& out, unsigned threads) {
+    Projection projection(pointers);
+    inParallel(StreamChunks(in), threads, [&](std::string_view chunk) {
+        std::string result;
+        forEachRecord(chunk, [&](std::string_view record) { projection.record(record, result); });
+        return result;
+    }, [&](const std::string& result) { out.write(result.data(), result.size()); });
+}
+
+std::string project(std::string_view in, const std::vector<std::string>& pointers, unsigned threads) {
+    Projection projection(pointers);
+    std::string out;
+    inParallel(ViewChunks(in), threads, [&](std::string_view chunk) {
+        std::string result;
+        forEachRecord(chunk, [&](std::string_view record) { projection.record(record, result); });
+        return result;
+    }, [&](const std::string& result) { out += result; });
+    return out;
+}
+
+Schema inferSchema(std::istream& in, unsigned threads) {
+    return inferChunks(StreamChunks(in), threads);
+}
+
+Schema inferSchema(std::string_view in, unsigned threads) {
+    return inferChunks(ViewChunks(in), threads);
+}
+
+};
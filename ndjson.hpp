@@ -0,0 +1,107 @@
+#ifndef JSON_NDJSON_HPP
+#define JSON_NDJSON_HPP
+
+#include "json.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Bulk operations over newline-delimited JSON, one record per line. Input is
+// cut into newline-aligned chunks that are processed on `threads` threads
+// (0 means one per core); output keeps input order. Records are scanned as
+// raw bytes and only checked for structure, not fully validated.
+
+// Writes, for each record, a compact object with only the members at the
+// given JSON pointers, nested as in the input and in the order the pointers
+// are given. Values are copied from the input as written; members a record
+// lacks are left out. Pointer tokens always name object members. Throws
+// json::Malformed if a record is not an object.
+void project(std::istream& in, const std::vector<std::string>& pointers, std::ostream& out, unsigned threads = 0);
+std::string project(std::string_view in, const std::vector<std::string>& pointers, unsigned threads = 0);
+
+// Estimates the number of distinct values added, to within about 2% with
+// its 2^12 registers. Sketches of disjoint inputs merge losslessly.
+class HyperLogLog {
+private:
+    std::array<uint8_t, 4096> registers{};
+public:
+    void add(std::string_view value);
+    void merge(const HyperLogLog& other);
+    double estimate() const;
+};
+
+// Everything seen at one path.
+struct FieldSchema {
+    // Values seen, of any type.
+    std::size_t values = 0;
+    std::array<std::size_t, 7> types{};
+    // Range of the numbers seen; min > max when there were none.
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    HyperLogLog strings;
+
+    std::size_t count(ValueType::Concrete type) const { return types[static_cast<std::size_t>(type)]; }
+    void merge(const FieldSchema& other);
+};
+
+// Fields are keyed by JSON pointer, the record itself being "". Elements of a
+// list share the path of the list followed by "/*".
+struct Schema {
+    std::size_t records = 0;
+    std::map<std::string, FieldSchema, std::less<>> fields;
+
+    // Fraction of the objects at the parent path that had this member; list
+    // elements and the record itself are always present.
+    double presence(std::string_view path) const;
+    void merge(const Schema& other);
+    std::ostream& dump(std::ostream& os) const;
+};
+
+// Each chunk is summarised independently and the summaries are merged. Throws
+// json::Malformed on invalid input.
+Schema inferSchema(std::istream& in, unsigned threads = 0);
+Schema inferSchema(std::string_view in, unsigned threads = 0);
+
+struct SortOptions {
+    // Roughly the input bytes held in memory at once; sorted runs beyond
+    // that are spilled to temporary files and merged.
+    std::size_t memory = std::size_t(1) << 30;
+    unsigned threads = 0;
+    // Where runs are spilled; the system temporary directory when empty.
+    std::string directory;
+    // Most spilled runs read at once; more are merged in several passes.
+    std::size_t fanIn = 64;
+};
+
+// Writes the records ordered by the value at a JSON pointer: missing first,
+// then null, false, true, numbers by value, strings by their unescaped bytes,
+// and other values by their text. Records with equal keys keep their input
+// order. Keys are found with the same raw scanner as project().
+void sortNdjson(std::istream& in, std::ostream& out, std::string_view pointer, SortOptions options = {});
+
+// Receives the records of each group in turn.
+class Aggregator {
+public:
+    virtual ~Aggregator();
+    // The key as written in the group's first record, empty when missing.
+    virtual void begin(std::string_view) { }
+    virtual void record(std::string_view) { }
+    virtual void end() { }
+};
+
+// Groups records with equal values at a JSON pointer, in sortNdjson order.
+void groupBy(std::istream& in, std::string_view pointer, Aggregator& aggregator, SortOptions options = {});
+
+};
+
+#endif
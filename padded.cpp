@@ -0,0 +1,34 @@
+#include "padded.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace json {
+
+PaddedString::PaddedString(size_t size) : data_(new char[size + padding]), size_(size) {
+    std::memset(data_.get() + size, 0, padding);
+}
+
+PaddedString::PaddedString(std::string_view text) : PaddedString(text.size()) {
+    std::memcpy(data_.get(), text.data(), text.size());
+}
+
+PaddedString PaddedString::load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) throw std::runtime_error("File not found.");
+    std::streamoff size = file.tellg();
+    if (size < 0) throw std::runtime_error("Cannot read " + filename + ".");
+    PaddedString result(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(result.data(), size)) throw std::runtime_error("Cannot read " + filename + ".");
+    return result;
+}
+
+PaddedBuffer::PaddedBuffer(std::span<char> memory, size_t size) : data_(memory.data()), size_(size) {
+    if (memory.size() < size || memory.size() - size < padding)
+        throw std::length_error("Buffer has no room for padding.");
+    std::memset(data_ + size, 0, padding);
+}
+
+};
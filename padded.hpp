@@ -0,0 +1,58 @@
+#ifndef JSON_PADDED_HPP
+#define JSON_PADDED_HPP
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace json {
+
+// Zeroed bytes guaranteed readable past the end of a padded buffer. The
+// parser reads whole blocks without bounds checks and relies on the zeros to
+// stop every scan: no JSON token continues through a NUL.
+constexpr size_t padding = 64;
+
+// Owns `size()` bytes followed by `padding` zeroed bytes.
+class PaddedString {
+private:
+    std::unique_ptr<char[]> data_;
+    size_t size_ = 0;
+public:
+    // Contents are left uninitialised; the padding is zeroed.
+    explicit PaddedString(size_t size = 0);
+    explicit PaddedString(std::string_view text);
+    PaddedString(PaddedString&&) = default;
+    PaddedString& operator=(PaddedString&&) = default;
+
+    // Reads a whole file; throws std::runtime_error if it cannot be read.
+    static PaddedString load(const std::string& filename);
+
+    char* data() { return data_.get(); }
+    const char* data() const { return data_.get(); }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::string_view view() const { return std::string_view(data_.get(), size_); }
+};
+
+// Non-owning view of padded memory.
+class PaddedBuffer {
+private:
+    char* data_;
+    size_t size_;
+public:
+    PaddedBuffer(PaddedString& string) : data_(string.data()), size_(string.size()) { }
+    // Uses the first `size` bytes of `memory` as content; the rest must be
+    // at least `padding` bytes long and is zeroed. Throws std::length_error
+    // otherwise.
+    PaddedBuffer(std::span<char> memory, size_t size);
+
+    char* data() const { return data_; }
+    size_t size() const { return size_; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+};
+
+};
+
+#endif
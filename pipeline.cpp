@@ -0,0 +1,271 @@
+#include "pipeline.hpp"
+#include "json.hpp"
+
+#include <charconv>
+#include <stdexcept>
+#include <set>
+#include <sstream>
+
+namespace json {
+
+namespace {
+
+// Strings longer than this stream through the stages in pieces.
+constexpr size_t chunk = 1 << 16;
+
+// Swallows one value, however deeply nested, once armed.
+class Skip {
+private:
+    bool armed = false;
+    size_t depth = 0;
+public:
+    void arm() { armed = true; }
+    bool active() const { return depth > 0; }
+    // Each returns true if the event belongs to a swallowed value.
+    bool scalar() {
+        if (depth) return true;
+        if (!armed) return false;
+        armed = false;
+        return true;
+    }
+    bool begin() {
+        if (depth) {
+            ++depth;
+            return true;
+        }
+        if (!armed) return false;
+        armed = false;
+        depth = 1;
+        return true;
+    }
+    bool end() {
+        if (!depth) return false;
+        --depth;
+        return true;
+    }
+};
+
+// Base for stages that remove whole values. Events of a value being
+// swallowed never reach the next stage.
+class Swallowing : public sax::Filter {
+private:
+    // Inside a chunked string being swallowed.
+    bool swallowingString = false;
+protected:
+    Skip skip;
+    // Called at the start of every value that is not already being
+    // swallowed; returning true swallows it.
+    virtual bool target() { return false; }
+    virtual void opened(bool) { }
+    virtual void closed() { }
+private:
+    bool scalar() { return skip.scalar() || target(); }
+    bool begin(bool object) {
+        if (skip.begin()) return true;
+        if (target()) {
+            skip.arm();
+            skip.begin();
+            return true;
+        }
+        opened(object);
+        return false;
+    }
+    bool end() {
+        if (skip.end()) return true;
+        closed();
+        return false;
+    }
+public:
+    void null() override {
+        if (!scalar()) Filter::null();
+    }
+    void boolean(bool value) override {
+        if (!scalar()) Filter::boolean(value);
+    }
+    void number(std::string_view lexeme) override {
+        if (!scalar()) Filter::number(lexeme);
+    }
+    void string(std::string_view value) override {
+        if (!scalar()) Filter::string(value);
+    }
+    void beginString() override {
+        swallowingString = scalar();
+        if (!swallowingString) Filter::beginString();
+    }
+    void stringChunk(std::string_view piece) override {
+        if (!swallowingString) Filter::stringChunk(piece);
+    }
+    void endString() override {
+        if (!swallowingString) Filter::endString();
+        swallowingString = false;
+    }
+    void beginObject() override {
+        if (!begin(true)) Filter::beginObject();
+    }
+    void beginList() override {
+        if (!begin(false)) Filter::beginList();
+    }
+    void endObject() override {
+        if (!end()) Filter::endObject();
+    }
+    void endList() override {
+        if (!end()) Filter::endList();
+    }
+};
+
+class Drop : public Swallowing {
+private:
+    struct Frame {
+        bool object;
+        // Whether the path to this container is a prefix of the pointer.
+        bool live;
+        size_t count;
+    };
+    std::vector<std::string> tokens;
+    std::vector<Frame> frames;
+    // Whether the member whose key was just seen continues the pointer.
+    bool keyLive = false;
+    // Whether the value that just started continues the pointer.
+    bool live = false;
+
+    static bool indexMatches(const std::string& token, size_t index) {
+        size_t value;
+        auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+        return error == std::errc() && end == token.data() + token.size() && value == index;
+    }
+protected:
+    bool target() override {
+        if (frames.empty()) {
+            live = true;
+            return false;
+        }
+        Frame& top = frames.back();
+        size_t depth = frames.size();
+        bool matches;
+        if (top.object) {
+            matches = keyLive;
+            keyLive = false;
+        } else {
+            size_t index = top.count++;
+            matches = top.live && depth <= tokens.size() && indexMatches(tokens[depth - 1], index);
+        }
+        live = matches && depth < tokens.size();
+        return matches && depth == tokens.size();
+    }
+    void opened(bool object) override { frames.push_back(Frame{object, live, 0}); }
+    void closed() override { frames.pop_back(); }
+public:
+    explicit Drop(std::string_view pointer) : tokens(pointerTokens(pointer)) {
+        if (tokens.empty()) throw std::runtime_error("Cannot drop the whole record.");
+    }
+    void key(std::string_view key) override {
+        if (skip.active()) return;
+        size_t depth = frames.size();
+        keyLive = frames.back().live && depth <= tokens.size() && key == tokens[depth - 1];
+        if (keyLive && depth == tokens.size()) {
+            keyLive = false;
+            skip.arm();
+            return;
+        }
+        Filter::key(key);
+    }
+};
+
+class Redact : public Swallowing {
+private:
+    std::set<std::string, std::less<>> keys;
+    std::string replacement;
+public:
+    Redact(std::vector<std::string> keys, std::string replacement)
+        : keys(keys.begin(), keys.end()), replacement(std::move(replacement)) { }
+    void key(std::string_view key) override {
+        if (skip.active()) return;
+        Filter::key(key);
+        if (keys.contains(key)) {
+            Filter::string(replacement);
+            skip.arm();
+        }
+    }
+};
+
+class Rename : public sax::Filter {
+private:
+    std::string from;
+    std::string to;
+public:
+    Rename(std::string from, std::string to) : from(std::move(from)), to(std::move(to)) { }
+    void key(std::string_view key) override { Filter::key(key == from ? to : key); }
+};
+
+class Truncate : public sax::Filter {
+private:
+    size_t length;
+    // The head of a chunked string: one byte past the limit shows whether
+    // the cut splits a sequence.
+    std::string head;
+public:
+    explicit Truncate(size_t length) : length(length) { }
+    void string(std::string_view value) override {
+        if (value.size() > length) {
+            size_t end = length;
+            // Back off over continuation bytes to the start of a sequence.
+            while (end > 0 && (static_cast<unsigned char>(value[end]) & 0xC0) == 0x80) --end;
+            value = value.substr(0, end);
+        }
+        Filter::string(value);
+    }
+    void beginString() override { head.clear(); }
+    void stringChunk(std::string_view piece) override {
+        if (head.size() <= length) head.append(piece.substr(0, length + 1 - head.size()));
+    }
+    void endString() override { string(head); }
+};
+
+// Connects the stages to each other and to the writer.
+sax::Handler& chain(std::vector<std::unique_ptr<sax::Filter>>& stages, sax::Handler& sink) {
+    if (stages.empty()) return sink;
+    for (size_t i = 0; i + 1 < stages.size(); ++i) stages[i]->connect(*stages[i + 1]);
+    stages.back()->connect(sink);
+    return *stages.front();
+}
+
+}
+
+Pipeline& Pipeline::drop(std::string_view pointer) {
+    return add(std::make_unique<Drop>(pointer));
+}
+
+Pipeline& Pipeline::redact(std::vector<std::string> keys, std::string replacement) {
+    return add(std::make_unique<Redact>(std::move(keys), std::move(replacement)));
+}
+
+Pipeline& Pipeline::rename(std::string from, std::string to) {
+    return add(std::make_unique<Rename>(std::move(from), std::move(to)));
+}
+
+Pipeline& Pipeline::truncate(size_t length) {
+    return add(std::make_unique<Truncate>(length));
+}
+
+Pipeline& Pipeline::add(std::unique_ptr<sax::Filter> stage) {
+    stages.push_back(std::move(stage));
+    return *this;
+}
+
+void Pipeline::run(std::istream& in, std::ostream& out) {
+    sax::Writer writer(out);
+    sax::parse(in, chain(stages, writer), sax::Options{.sequence = true, .chunk = chunk});
+}
+
+void Pipeline::run(std::string_view in, std::ostream& out) {
+    sax::Writer writer(out);
+    sax::parse(in, chain(stages, writer), sax::Options{.sequence = true, .chunk = chunk});
+}
+
+std::string Pipeline::run(std::string_view in) {
+    std::ostringstream out;
+    run(in, out);
+    return out.str();
+}
+
+};
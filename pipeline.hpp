@@ -0,0 +1,51 @@
+#ifndef JSON_PIPELINE_HPP
+#define JSON_PIPELINE_HPP
+
+#include "sax.hpp"
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Streams records from the SAX reader through a chain of filter stages into a
+// compact writer, one output line per input value. No tree is built; stages
+// see events in order and run in the order they were added. Long strings pass
+// through in pieces, so memory stays bounded whatever the input.
+//
+//     json::Pipeline()
+//         .drop("/user/password")
+//         .redact({"email", "phone"})
+//         .rename("ts", "timestamp")
+//         .truncate(256)
+//         .run(std::cin, std::cout);
+class Pipeline {
+private:
+    std::vector<std::unique_ptr<sax::Filter>> stages;
+public:
+    // Removes the member or element at a JSON pointer (RFC 6901).
+    Pipeline& drop(std::string_view pointer);
+    // Replaces the value of every member with one of these keys, at any depth.
+    Pipeline& redact(std::vector<std::string> keys, std::string replacement = "***");
+    // Renames members called `from`, at any depth.
+    Pipeline& rename(std::string from, std::string to);
+    // Shortens string values to at most `length` bytes without splitting a
+    // UTF-8 sequence. Keys are left alone.
+    Pipeline& truncate(size_t length);
+    // A user-defined stage.
+    Pipeline& add(std::unique_ptr<sax::Filter> stage);
+
+    // Input may be a single value or a sequence such as NDJSON. Throws
+    // json::Malformed on invalid input; stages keep no state across records.
+    void run(std::istream& in, std::ostream& out);
+    void run(std::string_view in, std::ostream& out);
+    std::string run(std::string_view in);
+};
+
+};
+
+#endif
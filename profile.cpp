@@ -0,0 +1,166 @@
+#include "profile.hpp"
+#include "sax.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <unordered_set>
+
+namespace json {
+
+namespace {
+
+class Profiler : public sax::Handler {
+private:
+    struct Frame {
+        std::size_t length;
+        uint64_t shape;
+    };
+    Profile& result;
+    std::vector<Frame> frames;
+    std::unordered_set<uint64_t> shapes;
+
+    void node(ValueType::Concrete type) {
+        std::size_t depth = frames.size();
+        if (result.depths.size() <= depth) result.depths.resize(depth + 1);
+        ++result.depths[depth];
+        ++result.nodes[static_cast<std::size_t>(type)];
+        if (!frames.empty()) ++frames.back().length;
+    }
+    static void bucket(std::vector<std::size_t>& histogram, std::size_t length) {
+        std::size_t index = std::bit_width(length);
+        if (histogram.size() <= index) histogram.resize(index + 1);
+        ++histogram[index];
+    }
+public:
+    Profiler(Profile& result) : result(result) { }
+    void scalar(ValueType::Concrete type) { node(type); }
+    void null() override { node(ValueType::Concrete::Null); }
+    void boolean(bool) override { node(ValueType::Concrete::Bool); }
+    void number(std::string_view lexeme) override {
+        bool isFloat = lexeme.find_first_of(".eE") != std::string_view::npos;
+        node(isFloat ? ValueType::Concrete::Float : ValueType::Concrete::Int);
+    }
+    void string(std::string_view value) override {
+        node(ValueType::Concrete::String);
+        bucket(result.stringLengths, value.size());
+    }
+    void key(std::string_view key) override {
+        auto it = result.keys.find(key);
+        if (it == result.keys.end()) result.keys.emplace(std::string(key), 1);
+        else ++it->second;
+        auto& shape = frames.back().shape;
+        shape = (shape ^ hashKey(key)) * 0x100000001b3;
+    }
+    void beginObject() override {
+        node(ValueType::Concrete::Object);
+        frames.push_back(Frame{0, 0xcbf29ce484222325});
+    }
+    void endObject() override {
+        uint64_t shape = frames.back().shape;
+        frames.pop_back();
+        ++result.objects;
+        if (!shapes.insert(shape).second) ++result.repeatedShapes;
+    }
+    void beginList() override {
+        node(ValueType::Concrete::List);
+        frames.push_back(Frame{0, 0});
+    }
+    void endList() override {
+        bucket(result.listLengths, frames.back().length);
+        frames.pop_back();
+    }
+    void endDocument() override { ++result.documents; }
+};
+
+void walk(const Node& node, Profiler& profiler) {
+    switch (node.type()) {
+        case ValueType::Concrete::Object:
+            profiler.beginObject();
+            for (auto& [key, child] : static_cast<const ObjectNode&>(node).getChildren()) {
+                profiler.key(key);
+                walk(*child, profiler);
+            }
+            profiler.endObject();
+            break;
+        case ValueType::Concrete::List:
+            profiler.beginList();
+            for (auto& child : static_cast<const ListNode&>(node).getChildren()) {
+                walk(*child, profiler);
+            }
+            profiler.endList();
+            break;
+        case ValueType::Concrete::String:
+            profiler.string(static_cast<const ValueNode<std::string>&>(node).view());
+            break;
+        case ValueType::Concrete::Bool:
+            profiler.boolean(static_cast<const ValueNode<bool>&>(node).value());
+            break;
+        case ValueType::Concrete::Null:
+            profiler.null();
+            break;
+        default:
+            profiler.scalar(node.type());
+    }
+}
+
+std::ostream& dumpHistogram(std::ostream& os, const std::vector<std::size_t>& histogram) {
+    os << "[";
+    for (std::size_t i = 0; i < histogram.size(); ++i) os << (i ? "," : "") << histogram[i];
+    return os << "]";
+}
+
+}
+
+std::size_t Profile::total() const {
+    std::size_t sum = 0;
+    for (auto count : nodes) sum += count;
+    return sum;
+}
+
+double Profile::repeatedShapeRatio() const {
+    return objects ? static_cast<double>(repeatedShapes) / objects : 0;
+}
+
+std::ostream& Profile::dump(std::ostream& os) const {
+    using Concrete = ValueType::Concrete;
+    os << "{\"documents\":" << documents << ",\"nodes\":{";
+    for (auto type : {Concrete::Object, Concrete::List, Concrete::String, Concrete::Float, Concrete::Int, Concrete::Bool, Concrete::Null}) {
+        os << (type == Concrete::Object ? "" : ",") << '"' << ValueType::toString(type) << "\":" << count(type);
+    }
+    os << "},\"depths\":";
+    dumpHistogram(os, depths);
+    os << ",\"keys\":{";
+    for (auto it = keys.begin(); it != keys.end(); ++it) {
+        if (it != keys.begin()) os << ",";
+        writeEscaped(os, it->first) << ":" << it->second;
+    }
+    os << "},\"stringLengths\":";
+    dumpHistogram(os, stringLengths);
+    os << ",\"listLengths\":";
+    dumpHistogram(os, listLengths);
+    return os << ",\"objects\":" << objects << ",\"repeatedShapeRatio\":" << repeatedShapeRatio() << "}";
+}
+
+Profile profile(const Json& json) {
+    Profile result;
+    Profiler profiler(result);
+    walk(json.node(), profiler);
+    profiler.endDocument();
+    return result;
+}
+
+Profile profile(std::string_view json) {
+    Profile result;
+    Profiler profiler(result);
+    sax::parse(json, profiler, sax::Options{.sequence = true});
+    return result;
+}
+
+Profile profile(std::istream& in) {
+    Profile result;
+    Profiler profiler(result);
+    sax::parse(in, profiler, sax::Options{.sequence = true});
+    return result;
+}
+
+};
@@ -0,0 +1,46 @@
+#ifndef JSON_PROFILE_HPP
+#define JSON_PROFILE_HPP
+
+#include "json.hpp"
+
+#include <array>
+#include <cstddef>
+#include <istream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Shape statistics of one or more documents. Length histograms are bucketed
+// by powers of two: bucket i counts lengths in [2^(i-1), 2^i), bucket 0 is
+// the empty case.
+struct Profile {
+    std::array<std::size_t, 7> nodes{};
+    // Node count at each depth, the root being at depth 0.
+    std::vector<std::size_t> depths;
+    std::map<std::string, std::size_t, std::less<>> keys;
+    std::vector<std::size_t> stringLengths;
+    std::vector<std::size_t> listLengths;
+    std::size_t objects = 0;
+    // Objects with a key set seen before. The DOM keeps keys sorted, so raw
+    // profiles also tell apart objects whose keys only differ in order.
+    std::size_t repeatedShapes = 0;
+    std::size_t documents = 0;
+
+    std::size_t count(ValueType::Concrete type) const { return nodes[static_cast<std::size_t>(type)]; }
+    std::size_t total() const;
+    double repeatedShapeRatio() const;
+    std::ostream& dump(std::ostream& os) const;
+};
+
+Profile profile(const Json& json);
+// Profiles raw text without building a tree. Accepts NDJSON as well as a
+// single document.
+Profile profile(std::string_view json);
+Profile profile(std::istream& in);
+
+};
+
+#endif
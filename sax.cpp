@@ -0,0 +1,434 @@
+#include "sax.hpp"
+#include "json.hpp"
+#include "simd.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace json::sax {
+
+Handler::~Handler() { }
+
+void Handler::endString() {
+    std::string value;
+    value.swap(pieces);
+    string(value);
+}
+
+namespace {
+
+constexpr size_t bufferSize = 1 << 16;
+
+bool isDigit(int c) { return '0' <= c && c <= '9'; }
+
+bool isNumberChar(int c) {
+    return isDigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+// -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+bool validNumber(std::string_view n) {
+    size_t i = 0;
+    auto digits = [&] {
+        size_t start = i;
+        while (i < n.size() && isDigit(n[i])) ++i;
+        return i > start;
+    };
+    if (i < n.size() && n[i] == '-') ++i;
+    if (i < n.size() && n[i] == '0') ++i;
+    else if (!digits()) return false;
+    if (i < n.size() && n[i] == '.') {
+        ++i;
+        if (!digits()) return false;
+    }
+    if (i < n.size() && (n[i] == 'e' || n[i] == 'E')) {
+        ++i;
+        if (i < n.size() && (n[i] == '+' || n[i] == '-')) ++i;
+        if (!digits()) return false;
+    }
+    return i == n.size();
+}
+
+void appendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+class Reader {
+private:
+    std::istream* in = nullptr;
+    std::unique_ptr<char[]> buffer;
+    const char* p;
+    const char* end;
+    std::string scratch;
+    std::vector<char> stack;
+    Handler& handler;
+    Options options;
+    const Kernels& scan = kernels();
+
+    bool fill() {
+        if (!in) return false;
+        in->read(buffer.get(), bufferSize);
+        p = buffer.get();
+        end = p + in->gcount();
+        return p != end;
+    }
+    int peek() {
+        if (p == end && !fill()) return EOF;
+        return static_cast<unsigned char>(*p);
+    }
+    int get() {
+        int c = peek();
+        if (c != EOF) ++p;
+        return c;
+    }
+    int skipWhitespace() {
+        for (;;) {
+            int c = peek();
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') return c;
+            ++p;
+        }
+    }
+    void expect(const char* rest) {
+        for (; *rest; ++rest) {
+            if (get() != *rest) throw Malformed();
+        }
+    }
+    uint32_t hex4() {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            int c = get();
+            value <<= 4;
+            if (isDigit(c)) value |= c - '0';
+            else if ('a' <= c && c <= 'f') value |= c - 'a' + 10;
+            else if ('A' <= c && c <= 'F') value |= c - 'A' + 10;
+            else throw Malformed();
+        }
+        return value;
+    }
+    void escape() {
+        switch (get()) {
+            case '"': scratch.push_back('"'); break;
+            case '\\': scratch.push_back('\\'); break;
+            case '/': scratch.push_back('/'); break;
+            case 'b': scratch.push_back('\b'); break;
+            case 'f': scratch.push_back('\f'); break;
+            case 'n': scratch.push_back('\n'); break;
+            case 'r': scratch.push_back('\r'); break;
+            case 't': scratch.push_back('\t'); break;
+            case 'u': {
+                uint32_t cp = hex4();
+                if (0xD800 <= cp && cp < 0xDC00) {
+                    expect("\\u");
+                    uint32_t low = hex4();
+                    if (low < 0xDC00 || low >= 0xE000) throw Malformed();
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                } else if (0xDC00 <= cp && cp < 0xE000) {
+                    throw Malformed();
+                }
+                appendUtf8(scratch, cp);
+                break;
+            }
+            default:
+                throw Malformed();
+        }
+    }
+    // Called after the opening quote. Strings without escapes that end inside
+    // the current buffer are returned without copying.
+    std::string_view string() {
+        const char* start = p;
+        const char* q = scan.findStringSpecial(p, end);
+        if (q != end && *q == '"') {
+            p = q + 1;
+            return std::string_view(start, q - start);
+        }
+        scratch.clear();
+        for (;;) {
+            q = scan.findStringSpecial(p, end);
+            scratch.append(p, q);
+            p = q;
+            if (character()) return scratch;
+        }
+    }
+    // Consumes the character that stopped a run; true at the closing quote.
+    bool character() {
+        int c = get();
+        if (c == '"') return true;
+        if (c == '\\') escape();
+        else if (c == EOF || c < 0x20) throw Malformed();
+        else scratch.push_back(static_cast<char>(c));
+        return false;
+    }
+    // A string value, in pieces when it is longer than options.chunk. Runs
+    // are passed straight from the buffer once nothing is pending.
+    void stringValue() {
+        if (!options.chunk) {
+            handler.string(string());
+            return;
+        }
+        const char* q = scan.findStringSpecial(p, end);
+        if (q != end && *q == '"' && static_cast<size_t>(q - p) <= options.chunk) {
+            handler.string(std::string_view(p, q - p));
+            p = q + 1;
+            return;
+        }
+        bool split = false;
+        auto piece = [&](std::string_view text) {
+            if (!split) handler.beginString();
+            split = true;
+            handler.stringChunk(text);
+        };
+        scratch.clear();
+        for (;;) {
+            q = scan.findStringSpecial(p, end);
+            for (;;) {
+                size_t room = options.chunk - scratch.size();
+                if (static_cast<size_t>(q - p) < room) break;
+                if (scratch.empty()) {
+                    piece(std::string_view(p, room));
+                } else {
+                    scratch.append(p, room);
+                    piece(scratch);
+                    scratch.clear();
+                }
+                p += room;
+            }
+            scratch.append(p, q);
+            p = q;
+            if (character()) break;
+            // An escape may take the piece a few bytes past the limit.
+            if (scratch.size() >= options.chunk) {
+                piece(scratch);
+                scratch.clear();
+            }
+        }
+        if (!split) {
+            handler.string(scratch);
+            return;
+        }
+        if (!scratch.empty()) handler.stringChunk(scratch);
+        handler.endString();
+    }
+    std::string_view number() {
+        const char* start = p;
+        const char* q = p;
+        while (q != end && isNumberChar(*q)) ++q;
+        std::string_view lexeme;
+        if (q != end) {
+            p = q;
+            lexeme = std::string_view(start, q - start);
+        } else {
+            scratch.assign(start, q);
+            p = q;
+            while (isNumberChar(peek())) scratch.push_back(*p++);
+            lexeme = scratch;
+        }
+        if (!validNumber(lexeme)) throw Malformed();
+        return lexeme;
+    }
+    void key() {
+        if (skipWhitespace() != '"') throw Malformed();
+        ++p;
+        handler.key(string());
+        if (skipWhitespace() != ':') throw Malformed();
+        ++p;
+    }
+    void value() {
+        for (;;) {
+            int c = skipWhitespace();
+            if (c == '-' || isDigit(c)) {
+                handler.number(number());
+            } else {
+                ++p;
+                switch (c) {
+                    case '{':
+                        handler.beginObject();
+                        if (skipWhitespace() == '}') {
+                            ++p;
+                            handler.endObject();
+                            break;
+                        }
+                        stack.push_back('{');
+                        key();
+                        continue;
+                    case '[':
+                        handler.beginList();
+                        if (skipWhitespace() == ']') {
+                            ++p;
+                            handler.endList();
+                            break;
+                        }
+                        stack.push_back('[');
+                        continue;
+                    case '"':
+                        stringValue();
+                        break;
+                    case 't':
+                        expect("rue");
+                        handler.boolean(true);
+                        break;
+                    case 'f':
+                        expect("alse");
+                        handler.boolean(false);
+                        break;
+                    case 'n':
+                        expect("ull");
+                        handler.null();
+                        break;
+                    default:
+                        throw Malformed();
+                }
+            }
+            // Close every container this value completes.
+            for (;;) {
+                if (stack.empty()) return;
+                c = skipWhitespace();
+                if (c == EOF) throw Malformed();
+                ++p;
+                if (c == ',') {
+                    if (stack.back() == '{') key();
+                    break;
+                }
+                if (c == '}' && stack.back() == '{') {
+                    stack.pop_back();
+                    handler.endObject();
+                } else if (c == ']' && stack.back() == '[') {
+                    stack.pop_back();
+                    handler.endList();
+                } else {
+                    throw Malformed();
+                }
+            }
+        }
+    }
+public:
+    Reader(std::string_view json, Handler& handler, Options options)
+        : p(json.data()), end(json.data() + json.size()), handler(handler), options(options) { }
+    Reader(std::istream& in, Handler& handler, Options options)
+        : in(&in), buffer(new char[bufferSize]), p(nullptr), end(nullptr), handler(handler), options(options) { }
+    void run() {
+        do {
+            if (skipWhitespace() == EOF) {
+                if (options.sequence) return;
+                throw Malformed();
+            }
+            value();
+            handler.endDocument();
+        } while (options.sequence);
+        if (skipWhitespace() != EOF) throw Malformed();
+    }
+};
+
+}
+
+Writer::Writer(std::ostream& os, int indent) : os(os), indent(indent) { }
+
+void Writer::newline() {
+    os.put('\n');
+    for (size_t i = 0; i < counts.size() * indent; ++i) os.put(' ');
+}
+
+void Writer::separate() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (counts.empty()) return;
+    if (counts.back()++ > 0) os.put(',');
+    if (indent) newline();
+}
+
+void Writer::null() {
+    separate();
+    os.write("null", 4);
+}
+
+void Writer::boolean(bool value) {
+    separate();
+    if (value) os.write("true", 4);
+    else os.write("false", 5);
+}
+
+void Writer::number(std::string_view lexeme) {
+    separate();
+    os.write(lexeme.data(), lexeme.size());
+}
+
+void Writer::string(std::string_view value) {
+    separate();
+    writeEscaped(os, value);
+}
+
+void Writer::key(std::string_view key) {
+    separate();
+    writeEscaped(os, key);
+    if (indent) os.write(": ", 2);
+    else os.put(':');
+    afterKey = true;
+}
+
+void Writer::beginString() {
+    separate();
+    os.put('"');
+}
+
+void Writer::stringChunk(std::string_view piece) {
+    writeEscapedRun(os, piece);
+}
+
+void Writer::endString() {
+    os.put('"');
+}
+
+void Writer::beginObject() {
+    separate();
+    os.put('{');
+    counts.push_back(0);
+}
+
+void Writer::endObject() {
+    bool empty = counts.back() == 0;
+    counts.pop_back();
+    if (indent && !empty) newline();
+    os.put('}');
+}
+
+void Writer::beginList() {
+    separate();
+    os.put('[');
+    counts.push_back(0);
+}
+
+void Writer::endList() {
+    bool empty = counts.back() == 0;
+    counts.pop_back();
+    if (indent && !empty) newline();
+    os.put(']');
+}
+
+void Writer::endDocument() {
+    os.put('\n');
+}
+
+void parse(std::string_view json, Handler& handler, Options options) {
+    Reader(json, handler, options).run();
+}
+
+void parse(std::istream& in, Handler& handler, Options options) {
+    Reader(in, handler, options).run();
+}
+
+};
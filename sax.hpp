@@ -0,0 +1,114 @@
+#ifndef JSON_SAX_HPP
+#define JSON_SAX_HPP
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json::sax {
+
+// Receives the events of a document in order. Views passed to the callbacks
+// are only valid for the duration of the call.
+class Handler {
+private:
+    // Collects a chunked string for the default callbacks below.
+    std::string pieces;
+public:
+    virtual ~Handler();
+    virtual void null() { }
+    virtual void boolean(bool) { }
+    // The number exactly as written in the input.
+    virtual void number(std::string_view) { }
+    // Strings and keys are unescaped.
+    virtual void string(std::string_view) { }
+    virtual void key(std::string_view) { }
+    // With Options::chunk set, longer string values arrive as beginString(),
+    // a stringChunk() per piece and endString() instead of one string() call.
+    // Pieces are unescaped and may split a UTF-8 sequence. By default they
+    // are collected and passed to string().
+    virtual void beginString() { pieces.clear(); }
+    virtual void stringChunk(std::string_view piece) { pieces.append(piece); }
+    virtual void endString();
+    virtual void beginObject() { }
+    virtual void endObject() { }
+    virtual void beginList() { }
+    virtual void endList() { }
+    // Called after each top-level value.
+    virtual void endDocument() { }
+};
+
+// Serialises the events it receives, compactly or indented by `indent`
+// spaces. Each top-level value is followed by a newline.
+class Writer : public Handler {
+private:
+    std::ostream& os;
+    int indent;
+    // Number of values written so far in each open container.
+    std::vector<size_t> counts;
+    bool afterKey = false;
+    void separate();
+    void newline();
+public:
+    Writer(std::ostream& os, int indent = 0);
+    void null() override;
+    void boolean(bool value) override;
+    void number(std::string_view lexeme) override;
+    void string(std::string_view value) override;
+    void key(std::string_view key) override;
+    void beginString() override;
+    void stringChunk(std::string_view piece) override;
+    void endString() override;
+    void beginObject() override;
+    void endObject() override;
+    void beginList() override;
+    void endList() override;
+    void endDocument() override;
+};
+
+// Forwards every event to the next handler. Stages of a pipeline derive from
+// it and override the events they transform, calling the base to pass them on.
+// Chunked strings are forwarded piece by piece, so a stage that rewrites
+// string() must handle them too.
+class Filter : public Handler {
+private:
+    Handler* next_ = nullptr;
+protected:
+    Handler& next() { return *next_; }
+public:
+    void connect(Handler& next) { next_ = &next; }
+    void null() override { next_->null(); }
+    void boolean(bool value) override { next_->boolean(value); }
+    void number(std::string_view lexeme) override { next_->number(lexeme); }
+    void string(std::string_view value) override { next_->string(value); }
+    void key(std::string_view key) override { next_->key(key); }
+    void beginString() override { next_->beginString(); }
+    void stringChunk(std::string_view piece) override { next_->stringChunk(piece); }
+    void endString() override { next_->endString(); }
+    void beginObject() override { next_->beginObject(); }
+    void endObject() override { next_->endObject(); }
+    void beginList() override { next_->beginList(); }
+    void endList() override { next_->endList(); }
+    void endDocument() override { next_->endDocument(); }
+};
+
+struct Options {
+    // Accept a whitespace separated sequence of values (e.g. NDJSON) instead
+    // of exactly one.
+    bool sequence = false;
+    // Deliver string values longer than this many bytes in pieces of about
+    // this size, so no whole value is ever held in memory. 0 never splits.
+    // Keys are always whole.
+    size_t chunk = 0;
+};
+
+// Both throw json::Malformed on invalid input. Containers are tracked on an
+// explicit stack, so nesting depth is bounded only by memory.
+void parse(std::string_view json, Handler& handler, Options options = {});
+// Reads the stream through a fixed-size buffer.
+void parse(std::istream& in, Handler& handler, Options options = {});
+
+};
+
+#endif
@@ -0,0 +1,381 @@
+#include "simd.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define JSON_X86 1
+#include <immintrin.h>
+#endif
+
+namespace json {
+
+namespace {
+
+bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Validates the multi-byte sequence starting at p; returns the position past
+// it, or nullptr if it is not well-formed (overlong forms, surrogates and
+// code points past U+10FFFF included).
+const char* utf8Sequence(const char* p, const char* end) {
+    unsigned char lead = *p;
+    size_t length;
+    uint32_t cp, min;
+    if ((lead & 0xE0) == 0xC0) {
+        length = 1, cp = lead & 0x1F, min = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 2, cp = lead & 0x0F, min = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length = 3, cp = lead & 0x07, min = 0x10000;
+    } else {
+        return nullptr;
+    }
+    if (static_cast<size_t>(end - p) <= length) return nullptr;
+    for (size_t i = 1; i <= length; ++i) {
+        unsigned char c = p[i];
+        if ((c & 0xC0) != 0x80) return nullptr;
+        cp = (cp << 6) | (c & 0x3F);
+    }
+    if (cp < min || cp > 0x10FFFF || (0xD800 <= cp && cp < 0xE000)) return nullptr;
+    return p + length + 1;
+}
+
+// Validates [p, stop) and returns where validation ended, which may be past
+// stop when a sequence straddles it, or nullptr on error.
+const char* utf8Run(const char* p, const char* stop, const char* end) {
+    while (p < stop) {
+        if (static_cast<unsigned char>(*p) < 0x80) ++p;
+        else if (!(p = utf8Sequence(p, end))) return nullptr;
+    }
+    return p;
+}
+
+namespace scalar {
+
+const char* findQuoteOrSpace(const char* p, const char* end) {
+    while (p != end && *p != '"' && static_cast<unsigned char>(*p) > 0x20) ++p;
+    return p;
+}
+
+const char* findQuoteOrBackslash(const char* p, const char* end) {
+    while (p != end && *p != '"' && *p != '\\') ++p;
+    return p;
+}
+
+const char* findStringSpecial(const char* p, const char* end) {
+    while (p != end && *p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20) ++p;
+    return p;
+}
+
+const char* skipWhitespace(const char* p, const char* end) {
+    while (p != end && isWhitespace(*p)) ++p;
+    return p;
+}
+
+bool validUtf8(const char* p, const char* end) {
+    return utf8Run(p, end, end) != nullptr;
+}
+
+}
+
+#ifdef JSON_X86
+
+// The vector kernels only differ in block width and intrinsics. Each scans
+// whole blocks and leaves the tail to its scalar counterpart.
+
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+
+namespace sse42 {
+
+__m128i load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+// Bytes <= limit, unsigned.
+__m128i atMost(__m128i block, char limit) {
+    __m128i bound = _mm_set1_epi8(limit);
+    return _mm_cmpeq_epi8(_mm_max_epu8(block, bound), bound);
+}
+__m128i equal(__m128i block, char c) { return _mm_cmpeq_epi8(block, _mm_set1_epi8(c)); }
+
+const char* findQuoteOrSpace(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        __m128i block = load(p);
+        if (int mask = _mm_movemask_epi8(_mm_or_si128(equal(block, '"'), atMost(block, 0x20)))) return p + __builtin_ctz(mask);
+    }
+    return scalar::findQuoteOrSpace(p, end);
+}
+
+const char* findQuoteOrBackslash(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        __m128i block = load(p);
+        if (int mask = _mm_movemask_epi8(_mm_or_si128(equal(block, '"'), equal(block, '\\')))) return p + __builtin_ctz(mask);
+    }
+    return scalar::findQuoteOrBackslash(p, end);
+}
+
+const char* findStringSpecial(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        __m128i block = load(p);
+        __m128i hits = _mm_or_si128(_mm_or_si128(equal(block, '"'), equal(block, '\\')), atMost(block, 0x1F));
+        if (int mask = _mm_movemask_epi8(hits)) return p + __builtin_ctz(mask);
+    }
+    return scalar::findStringSpecial(p, end);
+}
+
+const char* skipWhitespace(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        __m128i block = load(p);
+        __m128i spaces = _mm_or_si128(_mm_or_si128(equal(block, ' '), equal(block, '\n')),
+                                      _mm_or_si128(equal(block, '\r'), equal(block, '\t')));
+        if (int mask = ~_mm_movemask_epi8(spaces) & 0xFFFF) return p + __builtin_ctz(mask);
+    }
+    return scalar::skipWhitespace(p, end);
+}
+
+bool validUtf8(const char* p, const char* end) {
+    while (end - p >= 16) {
+        if (!_mm_movemask_epi8(load(p))) {
+            p += 16;
+        } else if (!(p = utf8Run(p, p + 16, end))) {
+            return false;
+        }
+    }
+    return scalar::validUtf8(p, end);
+}
+
+}
+
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+namespace avx2 {
+
+__m256i load(const char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+__m256i atMost(__m256i block, char limit) {
+    __m256i bound = _mm256_set1_epi8(limit);
+    return _mm256_cmpeq_epi8(_mm256_max_epu8(block, bound), bound);
+}
+__m256i equal(__m256i block, char c) { return _mm256_cmpeq_epi8(block, _mm256_set1_epi8(c)); }
+uint32_t bits(__m256i hits) { return static_cast<uint32_t>(_mm256_movemask_epi8(hits)); }
+
+const char* findQuoteOrSpace(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        __m256i block = load(p);
+        if (uint32_t mask = bits(_mm256_or_si256(equal(block, '"'), atMost(block, 0x20)))) return p + __builtin_ctz(mask);
+    }
+    return scalar::findQuoteOrSpace(p, end);
+}
+
+const char* findQuoteOrBackslash(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        __m256i block = load(p);
+        if (uint32_t mask = bits(_mm256_or_si256(equal(block, '"'), equal(block, '\\')))) return p + __builtin_ctz(mask);
+    }
+    return scalar::findQuoteOrBackslash(p, end);
+}
+
+const char* findStringSpecial(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        __m256i block = load(p);
+        __m256i hits = _mm256_or_si256(_mm256_or_si256(equal(block, '"'), equal(block, '\\')), atMost(block, 0x1F));
+        if (uint32_t mask = bits(hits)) return p + __builtin_ctz(mask);
+    }
+    return scalar::findStringSpecial(p, end);
+}
+
+const char* skipWhitespace(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        __m256i block = load(p);
+        __m256i spaces = _mm256_or_si256(_mm256_or_si256(equal(block, ' '), equal(block, '\n')),
+                                         _mm256_or_si256(equal(block, '\r'), equal(block, '\t')));
+        if (uint32_t mask = ~bits(spaces)) return p + __builtin_ctz(mask);
+    }
+    return scalar::skipWhitespace(p, end);
+}
+
+bool validUtf8(const char* p, const char* end) {
+    while (end - p >= 32) {
+        if (!bits(load(p))) {
+            p += 32;
+        } else if (!(p = utf8Run(p, p + 32, end))) {
+            return false;
+        }
+    }
+    return scalar::validUtf8(p, end);
+}
+
+}
+
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw")
+
+namespace avx512 {
+
+__m512i load(const char* p) { return _mm512_loadu_si512(p); }
+__mmask64 equal(__m512i block, char c) { return _mm512_cmpeq_epi8_mask(block, _mm512_set1_epi8(c)); }
+__mmask64 atMost(__m512i block, char limit) { return _mm512_cmple_epu8_mask(block, _mm512_set1_epi8(limit)); }
+
+const char* findQuoteOrSpace(const char* p, const char* end) {
+    for (; end - p >= 64; p += 64) {
+        __m512i block = load(p);
+        if (uint64_t mask = equal(block, '"') | atMost(block, 0x20)) return p + __builtin_ctzll(mask);
+    }
+    return scalar::findQuoteOrSpace(p, end);
+}
+
+const char* findQuoteOrBackslash(const char* p, const char* end) {
+    for (; end - p >= 64; p += 64) {
+        __m512i block = load(p);
+        if (uint64_t mask = equal(block, '"') | equal(block, '\\')) return p + __builtin_ctzll(mask);
+    }
+    return scalar::findQuoteOrBackslash(p, end);
+}
+
+const char* findStringSpecial(const char* p, const char* end) {
+    for (; end - p >= 64; p += 64) {
+        __m512i block = load(p);
+        if (uint64_t mask = equal(block, '"') | equal(block, '\\') | atMost(block, 0x1F)) return p + __builtin_ctzll(mask);
+    }
+    return scalar::findStringSpecial(p, end);
+}
+
+const char* skipWhitespace(const char* p, const char* end) {
+    for (; end - p >= 64; p += 64) {
+        __m512i block = load(p);
+        uint64_t spaces = equal(block, ' ') | equal(block, '\n') | equal(block, '\r') | equal(block, '\t');
+        if (uint64_t mask = ~spaces) return p + __builtin_ctzll(mask);
+    }
+    return scalar::skipWhitespace(p, end);
+}
+
+bool validUtf8(const char* p, const char* end) {
+    while (end - p >= 64) {
+        if (!_mm512_movepi8_mask(load(p))) {
+            p += 64;
+        } else if (!(p = utf8Run(p, p + 64, end))) {
+            return false;
+        }
+    }
+    return scalar::validUtf8(p, end);
+}
+
+}
+
+#pragma GCC pop_options
+
+#endif
+
+constexpr Kernels scalarKernels = {
+    scalar::findQuoteOrSpace, scalar::findQuoteOrBackslash, scalar::findStringSpecial,
+    scalar::skipWhitespace, scalar::validUtf8
+};
+
+#ifdef JSON_X86
+constexpr Kernels sse42Kernels = {
+    sse42::findQuoteOrSpace, sse42::findQuoteOrBackslash, sse42::findStringSpecial,
+    sse42::skipWhitespace, sse42::validUtf8
+};
+
+constexpr Kernels avx2Kernels = {
+    avx2::findQuoteOrSpace, avx2::findQuoteOrBackslash, avx2::findStringSpecial,
+    avx2::skipWhitespace, avx2::validUtf8
+};
+
+constexpr Kernels avx512Kernels = {
+    avx512::findQuoteOrSpace, avx512::findQuoteOrBackslash, avx512::findStringSpecial,
+    avx512::skipWhitespace, avx512::validUtf8
+};
+#endif
+
+const Kernels& table(Isa isa) {
+    switch (isa) {
+#ifdef JSON_X86
+        case Isa::SSE42:
+            return sse42Kernels;
+        case Isa::AVX2:
+            return avx2Kernels;
+        case Isa::AVX512:
+            return avx512Kernels;
+#endif
+        default:
+            return scalarKernels;
+    }
+}
+
+std::atomic<Isa> active;
+std::atomic<const Kernels*> current = nullptr;
+
+const Kernels& initialise() {
+    Isa isa = detectIsa();
+    if (const char* name = std::getenv("JSON_ISA")) {
+        for (Isa candidate : {Isa::Scalar, Isa::SSE42, Isa::AVX2, Isa::AVX512}) {
+            if (isaName(candidate) == name && supported(candidate)) isa = candidate;
+        }
+    }
+    active = isa;
+    current = &table(isa);
+    return table(isa);
+}
+
+}
+
+std::string_view isaName(Isa isa) {
+    switch (isa) {
+        case Isa::SSE42:
+            return "sse4.2";
+        case Isa::AVX2:
+            return "avx2";
+        case Isa::AVX512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
+
+bool supported(Isa isa) {
+#ifdef JSON_X86
+    switch (isa) {
+        case Isa::SSE42:
+            return __builtin_cpu_supports("sse4.2");
+        case Isa::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case Isa::AVX512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+        default:
+            return true;
+    }
+#else
+    return isa == Isa::Scalar;
+#endif
+}
+
+Isa detectIsa() {
+    for (Isa isa : {Isa::AVX512, Isa::AVX2, Isa::SSE42}) {
+        if (supported(isa)) return isa;
+    }
+    return Isa::Scalar;
+}
+
+Isa activeIsa() {
+    kernels();
+    return active;
+}
+
+void setIsa(Isa isa) {
+    if (!supported(isa)) throw std::runtime_error("Instruction set " + std::string(isaName(isa)) + " is not supported.");
+    active = isa;
+    current = &table(isa);
+}
+
+const Kernels& kernels() {
+    if (const Kernels* kernels = current.load(std::memory_order_acquire)) return *kernels;
+    return initialise();
+}
+
+};
@@ -0,0 +1,49 @@
+#ifndef JSON_SIMD_HPP
+#define JSON_SIMD_HPP
+
+#include <cstddef>
+#include <string_view>
+
+namespace json {
+
+enum class Isa {
+    Scalar, SSE42, AVX2, AVX512
+};
+
+// "scalar", "sse4.2", "avx2" or "avx512".
+std::string_view isaName(Isa isa);
+// Whether this CPU and OS can run the instruction set.
+bool supported(Isa isa);
+// The widest supported instruction set.
+Isa detectIsa();
+// The instruction set the kernels run with. Chosen on first use: the JSON_ISA
+// environment variable if set to one of the names above, else detectIsa().
+Isa activeIsa();
+// Switches every kernel to `isa`, e.g. to compare implementations in tests
+// or benchmarks. Throws std::runtime_error if it is not supported.
+void setIsa(Isa isa);
+
+// Byte scanners shared by the tokenizer, the streaming transforms and the
+// escaper. Each returns the first position in [p, end) holding a byte of its
+// class, or end. All implementations of a kernel give identical results.
+struct Kernels {
+    // '"' or any byte <= 0x20.
+    const char* (*findQuoteOrSpace)(const char* p, const char* end);
+    // '"' or '\\'.
+    const char* (*findQuoteOrBackslash)(const char* p, const char* end);
+    // '"', '\\' or a control character: where a string run ends.
+    const char* (*findStringSpecial)(const char* p, const char* end);
+    // Anything but JSON whitespace.
+    const char* (*skipWhitespace)(const char* p, const char* end);
+    bool (*validUtf8)(const char* p, const char* end);
+};
+
+const Kernels& kernels();
+
+inline bool validUtf8(std::string_view text) {
+    return kernels().validUtf8(text.data(), text.data() + text.size());
+}
+
+};
+
+#endif
@@ -0,0 +1,84 @@
+#include "stats.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace json {
+
+namespace {
+
+// Plain thread_locals without dynamic initialisation, so they are safe to touch
+// from inside operator new.
+thread_local Stats threadStats;
+#ifdef JSON_STATS
+thread_local Phase currentPhase = Phase::None;
+#endif
+
+}
+
+Counters& Counters::operator+=(const Counters& other) {
+    allocations += other.allocations;
+    bytes += other.bytes;
+    frees += other.frees;
+    return *this;
+}
+
+Counters Counters::operator-(const Counters& other) const {
+    return Counters{allocations - other.allocations, bytes - other.bytes, frees - other.frees};
+}
+
+Counters Stats::total() const {
+    Counters sum;
+    for (auto& counters : phases) sum += counters;
+    return sum;
+}
+
+Stats Stats::operator-(const Stats& other) const {
+    Stats diff;
+    for (std::size_t i = 0; i < phaseCount; ++i) diff.phases[i] = phases[i] - other.phases[i];
+    return diff;
+}
+
+Stats stats() {
+    return threadStats;
+}
+
+void resetStats() {
+    threadStats = Stats{};
+}
+
+#ifdef JSON_STATS
+PhaseScope::PhaseScope(Phase phase) : previous(currentPhase) {
+    currentPhase = phase;
+}
+
+PhaseScope::~PhaseScope() {
+    currentPhase = previous;
+}
+#endif
+
+}; // namespace json
+
+#ifdef JSON_STATS
+// Only allocations made while a phase is active are attributed; everything
+// else the process does goes through untouched.
+void* operator new(std::size_t size) {
+    if (json::currentPhase != json::Phase::None) {
+        auto& counters = json::threadStats.phases[static_cast<std::size_t>(json::currentPhase)];
+        ++counters.allocations;
+        counters.bytes += size;
+    }
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    if (p && json::currentPhase != json::Phase::None)
+        ++json::threadStats.phases[static_cast<std::size_t>(json::currentPhase)].frees;
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+#endif
@@ -0,0 +1,76 @@
+#ifndef JSON_STATS_HPP
+#define JSON_STATS_HPP
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace json {
+
+// Allocation counters are only collected when the library is built with
+// -DJSON_STATS. Otherwise every counter stays at zero and PhaseScope is empty.
+// Load is reading a file into memory. Build is the whole parse: the parser
+// lexes and builds nodes in one pass, so the two cannot be told apart.
+enum class Phase {
+    None, Load, Build, Lookup, Dump
+};
+
+constexpr std::size_t phaseCount = 5;
+
+constexpr std::string phaseName(Phase phase) {
+    switch (phase) {
+        case Phase::Load:
+            return "load";
+        case Phase::Build:
+            return "build";
+        case Phase::Lookup:
+            return "lookup";
+        case Phase::Dump:
+            return "dump";
+        default:
+            return "none";
+    }
+}
+
+struct Counters {
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+    std::size_t frees = 0;
+
+    Counters& operator+=(const Counters& other);
+    Counters operator-(const Counters& other) const;
+};
+
+struct Stats {
+    std::array<Counters, phaseCount> phases{};
+
+    const Counters& operator[](Phase phase) const { return phases[static_cast<std::size_t>(phase)]; }
+    Counters total() const;
+    // Subtracting an earlier snapshot gives the counters of a single document.
+    Stats operator-(const Stats& other) const;
+};
+
+// Counters of the calling thread, per phase.
+Stats stats();
+void resetStats();
+
+#ifdef JSON_STATS
+class PhaseScope {
+private:
+    Phase previous;
+public:
+    explicit PhaseScope(Phase phase);
+    ~PhaseScope();
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+};
+#else
+class PhaseScope {
+public:
+    explicit PhaseScope(Phase) { }
+};
+#endif
+
+};
+
+#endif
@@ -0,0 +1,252 @@
+#include "stream.hpp"
+#include "simd.hpp"
+
+#include <cstring>
+#include <memory>
+
+namespace json {
+
+namespace {
+
+constexpr size_t blockSize = 1 << 16;
+
+class StreamSink {
+private:
+    std::ostream& os;
+    std::unique_ptr<char[]> buffer;
+    size_t size = 0;
+public:
+    StreamSink(std::ostream& os) : os(os), buffer(new char[blockSize]) { }
+    ~StreamSink() { flush(); }
+    void flush() {
+        os.write(buffer.get(), size);
+        size = 0;
+    }
+    void append(const char* p, size_t n) {
+        if (size + n > blockSize) {
+            flush();
+            if (n > blockSize) {
+                os.write(p, n);
+                return;
+            }
+        }
+        std::memcpy(buffer.get() + size, p, n);
+        size += n;
+    }
+    void put(char ch) {
+        if (size == blockSize) flush();
+        buffer[size++] = ch;
+    }
+};
+
+class StringSink {
+private:
+    std::string& out;
+public:
+    StringSink(std::string& out) : out(out) { }
+    void append(const char* p, size_t n) { out.append(p, n); }
+    void put(char ch) { out.push_back(ch); }
+};
+
+// State shared by both transforms: where we are relative to strings, and
+// whether a newline is owed between two top-level values.
+struct Position {
+    bool inString = false;
+    bool escaped = false;
+    bool wrote = false;
+    bool pendingNewline = false;
+    long depth = 0;
+};
+
+// Copies string contents starting at p; returns where copying stopped.
+template <typename Sink>
+const char* copyString(const Kernels& scan, Position& at, Sink& out, const char* p, const char* end) {
+    if (at.escaped) {
+        out.put(*p);
+        at.escaped = false;
+        return p + 1;
+    }
+    const char* q = scan.findQuoteOrBackslash(p, end);
+    out.append(p, q - p);
+    if (q == end) return q;
+    out.put(*q);
+    if (*q == '"') at.inString = false;
+    else at.escaped = true;
+    return q + 1;
+}
+
+template <typename Sink>
+class Minifier {
+private:
+    Sink& out;
+    const Kernels& scan = kernels();
+    Position at;
+    void begin() {
+        if (at.pendingNewline) out.put('\n');
+        at.pendingNewline = false;
+        at.wrote = true;
+    }
+public:
+    Minifier(Sink& out) : out(out) { }
+    void feed(const char* p, const char* end) {
+        while (p != end) {
+            if (at.inString) {
+                p = copyString(scan, at, out, p, end);
+                continue;
+            }
+            const char* q = scan.findQuoteOrSpace(p, end);
+            if (q != p) {
+                begin();
+                for (const char* c = p; c != q; ++c)
+                    at.depth += (*c == '{' || *c == '[') - (*c == '}' || *c == ']');
+                out.append(p, q - p);
+            }
+            if (q == end) return;
+            if (*q == '"') {
+                begin();
+                out.put('"');
+                at.inString = true;
+            } else if (at.depth == 0 && at.wrote) {
+                at.pendingNewline = true;
+            }
+            p = q + 1;
+        }
+    }
+    void finish() {
+        if (at.pendingNewline) out.put('\n');
+    }
+};
+
+template <typename Sink>
+class Reformatter {
+private:
+    Sink& out;
+    const Kernels& scan = kernels();
+    int indent;
+    Position at;
+    // Set after an opening bracket until we know whether the container is empty.
+    bool open = false;
+    void newline() {
+        static constexpr char spaces[] = "                                ";
+        out.put('\n');
+        for (long n = at.depth * indent; n > 0; n -= sizeof(spaces) - 1)
+            out.append(spaces, std::min<long>(n, sizeof(spaces) - 1));
+    }
+public:
+    Reformatter(Sink& out, int indent) : out(out), indent(indent) { }
+    void feed(const char* p, const char* end) {
+        while (p != end) {
+            if (at.inString) {
+                p = copyString(scan, at, out, p, end);
+                continue;
+            }
+            char ch = *p++;
+            if (ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t') {
+                if (at.depth == 0 && at.wrote) at.pendingNewline = true;
+                continue;
+            }
+            if (at.pendingNewline) out.put('\n');
+            at.pendingNewline = false;
+            at.wrote = true;
+            if (open) {
+                open = false;
+                if (ch == '}' || ch == ']') {
+                    --at.depth;
+                    out.put(ch);
+                    continue;
+                }
+                newline();
+            }
+            switch (ch) {
+                case '{':
+                case '[':
+                    out.put(ch);
+                    ++at.depth;
+                    open = true;
+                    break;
+                case '}':
+                case ']':
+                    --at.depth;
+                    newline();
+                    out.put(ch);
+                    break;
+                case ',':
+                    out.put(',');
+                    newline();
+                    break;
+                case ':':
+                    out.append(": ", 2);
+                    break;
+                case '"':
+                    out.put('"');
+                    at.inString = true;
+                    break;
+                default:
+                    out.put(ch);
+            }
+        }
+    }
+    void finish() {
+        if (at.wrote) out.put('\n');
+    }
+};
+
+template <typename Transform>
+void run(std::istream& in, Transform& transform) {
+    std::unique_ptr<char[]> buffer(new char[blockSize]);
+    while (in) {
+        in.read(buffer.get(), blockSize);
+        if (in.gcount() == 0) break;
+        transform.feed(buffer.get(), buffer.get() + in.gcount());
+    }
+    transform.finish();
+}
+
+}
+
+void minify(std::istream& in, std::ostream& out) {
+    StreamSink sink(out);
+    Minifier minifier(sink);
+    run(in, minifier);
+}
+
+void minify(std::string_view in, std::ostream& out) {
+    StreamSink sink(out);
+    Minifier minifier(sink);
+    minifier.feed(in.data(), in.data() + in.size());
+    minifier.finish();
+}
+
+std::string minify(std::string_view in) {
+    std::string out;
+    out.reserve(in.size());
+    StringSink sink(out);
+    Minifier minifier(sink);
+    minifier.feed(in.data(), in.data() + in.size());
+    minifier.finish();
+    return out;
+}
+
+void reformat(std::istream& in, std::ostream& out, int indent) {
+    StreamSink sink(out);
+    Reformatter reformatter(sink, indent);
+    run(in, reformatter);
+}
+
+void reformat(std::string_view in, std::ostream& out, int indent) {
+    StreamSink sink(out);
+    Reformatter reformatter(sink, indent);
+    reformatter.feed(in.data(), in.data() + in.size());
+    reformatter.finish();
+}
+
+std::string reformat(std::string_view in, int indent) {
+    std::string out;
+    StringSink sink(out);
+    Reformatter reformatter(sink, indent);
+    reformatter.feed(in.data(), in.data() + in.size());
+    reformatter.finish();
+    return out;
+}
+
+};
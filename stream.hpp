@@ -0,0 +1,26 @@
+#ifndef JSON_STREAM_HPP
+#define JSON_STREAM_HPP
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace json {
+
+// Byte-level transforms that never build a tree and never validate: string
+// contents (escapes included) are copied through unchanged, and streams are
+// processed in fixed-size blocks. Whitespace between top-level values is
+// collapsed into a single newline, so NDJSON stays line-delimited.
+void minify(std::istream& in, std::ostream& out);
+void minify(std::string_view in, std::ostream& out);
+std::string minify(std::string_view in);
+
+// Re-indents by `indent` spaces per level, one member or element per line.
+void reformat(std::istream& in, std::ostream& out, int indent = 2);
+void reformat(std::string_view in, std::ostream& out, int indent = 2);
+std::string reformat(std::string_view in, int indent = 2);
+
+};
+
+#endif
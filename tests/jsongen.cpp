@@ -0,0 +1,35 @@
+// Round-trips every record of a sample through the structs jsongen generated
+// from it and from its schema.
+#include "tests/generated.hpp"
+#include "tests/generated_schema.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+template <typename Parse, typename Serialize>
+bool roundTrip(const std::string& line, Parse parse, Serialize serialize) {
+    std::ostringstream os;
+    serialize(os, parse(line));
+    if (os.str() == line) return true;
+    std::cerr << "Round trip failed:\n  " << line << "\n  " << os.str() << "\n";
+    return false;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) return 2;
+    std::ifstream in(argv[1]);
+    std::string line;
+    int records = 0;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        if (!roundTrip(line, sample::parse, [](std::ostream& os, const sample::Record& r) { sample::serialize(os, r); }))
+            return 1;
+        if (!roundTrip(line, schema::parse, [](std::ostream& os, const schema::Record& r) { schema::serialize(os, r); }))
+            return 1;
+        ++records;
+    }
+    std::cout << records << " records round-tripped." << std::endl;
+    return records > 0 ? 0 : 1;
+}
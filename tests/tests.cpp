@@ -1,8 +1,19 @@
 #include "json.hpp"
+#include "stats.hpp"
+#include "trace.hpp"
+#include "profile.hpp"
+#include "convert.hpp"
+#include "stream.hpp"
+#include "pipeline.hpp"
+#include "sax.hpp"
+#include "ndjson.hpp"
+#include "simd.hpp"
+#include <cstring>
 #include <sstream>
 #include <fstream>
 #include <string_view>
 #include <iostream>
+#include <ranges>
 
 constexpr std::string_view sampleJsonFile = "tests/sample.json";
 
@@ -67,7 +78,715 @@ void get() {
     assertEqual(zip, expectedZip);
 }
 
+void stats() {
+    json::resetStats();
+    json::Json json = json::fromFile(sampleJsonFile.data());
+    json["address"]["city"].as<std::string>();
+    json::Stats stats = json::stats();
+#ifdef JSON_STATS
+    // Reading the file counts as Load and parsing it as Build.
+    assertEqual(stats[json::Phase::Load].allocations > 0, true);
+    assertEqual(stats[json::Phase::Build].allocations > 0, true);
+    // Existing keys are found without allocating; missing ones insert a node.
+    assertEqual(stats[json::Phase::Lookup].allocations, size_t(0));
+    json["missing"];
+    stats = json::stats();
+    assertEqual(stats[json::Phase::Lookup].allocations > 0, true);
+#else
+    assertEqual(stats.total().allocations, size_t(0));
+#endif
+    json::Stats later = json::stats();
+    assertEqual((later - stats).total().allocations, size_t(0));
+}
+
+void latency() {
+    json::Histogram histogram;
+    for (uint64_t i = 1; i <= 1000; ++i) histogram.record(i);
+    assertEqual(histogram.count(), uint64_t(1000));
+    assertEqual(histogram.max(), uint64_t(1000));
+    uint64_t p50 = histogram.percentile(50);
+    assertEqual(p50 >= 500 && p50 <= 500 + 500 / 16, true);
+    assertEqual(histogram.percentile(100), uint64_t(1000));
+
+    json::resetLatency();
+    json::Json json = json::fromFile(sampleJsonFile.data());
+    std::ostringstream os;
+    os << json;
+#ifdef JSON_TRACE
+    assertEqual(json::latency(json::Operation::FromFile).count(), uint64_t(1));
+    assertEqual(json::latency(json::Operation::Dump).count(), uint64_t(1));
+#else
+    assertEqual(json::latency(json::Operation::FromFile).count(), uint64_t(0));
+#endif
+}
+
+void profile() {
+    json::Json json = json::fromFile(sampleJsonFile.data());
+    json::Profile tree = json::profile(json);
+    std::ifstream file(sampleJsonFile.data());
+    json::Profile raw = json::profile(file);
+
+    for (auto profile : {tree, raw}) {
+        assertEqual(profile.documents, size_t(1));
+        assertEqual(profile.count(json::ValueType::Concrete::Object), size_t(3));
+        assertEqual(profile.count(json::ValueType::Concrete::String), size_t(8));
+        assertEqual(profile.count(json::ValueType::Concrete::Int), size_t(3));
+        assertEqual(profile.count(json::ValueType::Concrete::Float), size_t(1));
+        assertEqual(profile.total(), size_t(18));
+        assertEqual(profile.depths.size(), size_t(4));
+        assertEqual(profile.keys.at("name"), size_t(2));
+        assertEqual(profile.listLengths[2], size_t(1));
+    }
+
+    json::Profile records = json::profile(std::string_view("{\"a\": 1, \"b\": [true, null]}\n{\"a\": 2, \"b\": []}\n"));
+    assertEqual(records.documents, size_t(2));
+    assertEqual(records.repeatedShapes, size_t(1));
+    assertEqual(records.count(json::ValueType::Concrete::Null), size_t(1));
+}
+
+void iterate() {
+    static_assert(std::ranges::bidirectional_range<json::Json::Items>);
+    static_assert(std::ranges::view<json::Json::Elements>);
+
+    json::Json json = json::fromFile(sampleJsonFile.data());
+    std::string keys;
+    for (auto [key, value] : json["address"].items()) {
+        keys += std::string(key) + ",";
+    }
+    assertEqual(keys, std::string("city,state,street,zip,"));
+
+    auto strings = json["friends"].elements()
+        | std::views::filter([](json::Json::View view) { return view.type() == json::ValueType::Concrete::String; });
+    assertEqual(std::ranges::distance(strings), std::ptrdiff_t(1));
+    assertEqual((*strings.begin()).as<std::string>(), std::string("Bob"));
+
+    for (auto [key, value] : json["friends"][1].items()) {
+        if (value.type() == json::ValueType::Concrete::Int) value = 30;
+    }
+    assertEqual(json["friends"][1]["age"].as<int>(), 30);
+
+    json["nickname"] = std::string("JD");
+    assertEqual(json["nickname"].as<std::string>(), std::string("JD"));
+
+    // Views refer to slots rather than owning nodes: a temporary's views last
+    // for the full expression, and views below the root follow the nodes when
+    // the document moves.
+    assertEqual(json::parse("{\"a\":[1,2]}")["a"][1].as<int>(), 2);
+    json::Json::View city = json["address"]["city"];
+    json["added"] = 1;
+    json::Json moved = std::move(json);
+    city = std::string("Paris");
+    assertEqual(moved["address"]["city"].as<std::string>(), std::string("Paris"));
+}
+
+void keys() {
+    constexpr json::KeyRef age = json::key("age");
+    static_assert(age.name == json::Key<"age">::name);
+    static_assert(json::hashKey("age") != json::hashKey("agE"));
+
+    json::Json json = json::fromFile(sampleJsonFile.data());
+    assertEqual(json[age].as<int>(), 24);
+    assertEqual(json[json::Key<"address">{}][json::Key<"city">{}].as<std::string>(), std::string("Springfield"));
+    std::string_view name = "name";
+    assertEqual(json[name].as<std::string>(), std::string("Jane"));
+}
+
+void checked() {
+    json::Json json = json::fromFile(sampleJsonFile.data());
+    assertEqual(json["age"].get<float>(), 24.0f);
+    assertEqual(json["friends"][1]["money"].get_if<int>().has_value(), false);
+    assertEqual(json["name"].get_if<std::string>().value(), std::string("Jane"));
+    assertEqual(json::Json(3).get<float>(), 3.0f);
+
+    bool thrown = false;
+    try {
+        json["name"].get<int>();
+    } catch (const json::WrongObjectType&) {
+        thrown = true;
+    }
+    assertEqual(thrown, true);
+}
+
+void convert() {
+    std::vector<double> values = {1.5, 2.5, 3.5};
+    json::Json list = json::to_json(values);
+    assertEqual(list[2].as<float>(), 3.5f);
+    assertEqual(json::from_json<std::vector<double>>(list)[1], 2.5);
+
+    std::map<std::string, std::vector<int>> map = {{"a", {1, 2}}, {"b", {}}};
+    json::Json object = json::to_json(std::move(map));
+    std::ostringstream os;
+    os << object;
+    assertEqual(os.str(), std::string("{\"a\":[1,2],\"b\":[]}"));
+
+    auto tuple = json::from_json<std::tuple<std::string, int, std::optional<bool>>>(
+        json::to_json(std::make_tuple(std::string("x"), 7, std::optional<bool>())));
+    assertEqual(std::get<0>(tuple), std::string("x"));
+    assertEqual(std::get<1>(tuple), 7);
+    assertEqual(std::get<2>(tuple).has_value(), false);
+
+    std::array<std::variant<int, std::string>, 2> mixed = {7, std::string("seven")};
+    auto back = json::from_json<std::array<std::variant<int, std::string>, 2>>(json::to_json(mixed));
+    assertEqual(std::get<std::string>(back[1]), std::string("seven"));
+
+    int raw[] = {4, 5, 6};
+    assertEqual(json::to_json(std::span(raw))[1].as<int>(), 5);
+
+    json::Json sample = json::fromFile(sampleJsonFile.data());
+    auto address = json::from_json<std::unordered_map<std::string, std::variant<int, std::string>>>(sample["address"]);
+    assertEqual(std::get<int>(address.at("zip")), 62701);
+
+    // Wide numbers keep their value; narrow targets reject what they cannot hold.
+    std::tuple<int64_t, double, uint16_t> wide = {12345678901, 0.1, 65535};
+    json::Json stored = json::to_json(wide);
+    std::ostringstream written;
+    written << stored;
+    assertEqual(written.str(), std::string("[12345678901,0.1,65535]"));
+    assertEqual((json::from_json<std::tuple<int64_t, double, uint16_t>>(stored) == wide), true);
+    int thrown = 0;
+    try { json::from_json<int>(stored[0]); } catch (const json::WrongObjectType&) { ++thrown; }
+    try { json::from_json<int16_t>(stored[2]); } catch (const json::WrongObjectType&) { ++thrown; }
+    try { json::from_json<int64_t>(stored[1]); } catch (const json::WrongObjectType&) { ++thrown; }
+    try { json::from_json<double>(json::parse("1e400")); } catch (const json::WrongObjectType&) { ++thrown; }
+    assertEqual(thrown, 4);
+
+    std::vector<bool> flags = {true, false, true};
+    json::Json bits = json::to_json(flags);
+    assertEqual(bits[1].as<bool>(), false);
+    assertEqual(json::from_json<std::vector<bool>>(bits) == flags, true);
+}
+
+void minify() {
+    std::string spaced = "{ \"a b\" : [1, 2,\t{ }],\n \"c\\\" d\": \"e \\\\\" }\n\n[ ]\n";
+    assertEqual(json::minify(spaced), std::string("{\"a b\":[1,2,{}],\"c\\\" d\":\"e \\\\\"}\n[]\n"));
+    assertEqual(json::reformat(std::string_view("{\"a\":[1,{}],\"b\":[]}")),
+                std::string("{\n  \"a\": [\n    1,\n    {}\n  ],\n  \"b\": []\n}\n"));
+
+    // Streams are processed in blocks; results must not depend on where they split.
+    std::string large = "[";
+    for (int i = 0; i < 20000; ++i) large += (i ? ", " : "") + std::string("{ \"k\\\"\" : \"v  \\\\\" }");
+    large += "]";
+    std::istringstream in(large);
+    std::ostringstream out;
+    json::minify(in, out);
+    assertEqual(out.str() == json::minify(large), true);
+    assertEqual(out.str().find(' ') != std::string::npos, true);
+
+    std::ofstream("tests/escaped.json") << "{\"quote \\\" inside\": \"a b\"}";
+    json::Json json = json::fromFile("tests/escaped.json");
+    std::remove("tests/escaped.json");
+    assertEqual(json["quote \" inside"].as<std::string>(), std::string("a b"));
+}
+
+void pipeline() {
+    std::string records =
+        "{\"ts\":1,\"user\":{\"id\":7,\"password\":{\"x\":[1]}},\"email\":\"a@b\",\"tags\":[\"a\",\"b\",\"c\"]}\n"
+        "{\"ts\":2,\"note\":\"h\u00e9llo\",\"inner\":{\"email\":[1,2]}}\n";
+    json::Pipeline pipeline;
+    pipeline.drop("/user/password").drop("/tags/1").redact({"email"}).rename("ts", "time").truncate(2);
+    assertEqual(pipeline.run(records), std::string(
+        "{\"time\":1,\"user\":{\"id\":7},\"email\":\"**\",\"tags\":[\"a\",\"c\"]}\n"
+        "{\"time\":2,\"note\":\"h\",\"inner\":{\"email\":\"**\"}}\n"));
+
+    // User-defined stages see the same events.
+    struct Negate : json::sax::Filter {
+        void boolean(bool value) override { Filter::boolean(!value); }
+    };
+    std::istringstream in("[true, false]");
+    std::ostringstream out;
+    json::Pipeline().add(std::make_unique<Negate>()).run(in, out);
+    assertEqual(out.str(), std::string("[false,true]\n"));
+}
+
+void project() {
+    std::string records =
+        "{\"ts\": 1, \"user\": {\"id\": 7, \"name\": \"a\"}, \"status\": [1, 2], \"x\": \"}\\\"\"}\n"
+        "\n"
+        "{\"user\": 3, \"status\": \"ok\", \"ts\": 2}\n"
+        "{\"other\": {}}\n";
+    std::vector<std::string> pointers = {"/ts", "/user/id", "/status"};
+    assertEqual(json::project(records, pointers), std::string(
+        "{\"ts\":1,\"user\":{\"id\":7},\"status\":[1,2]}\n"
+        "{\"ts\":2,\"status\":\"ok\"}\n"
+        "{}\n"));
+
+    // Enough records for several chunks on several threads; order is kept.
+    std::string many;
+    for (int i = 0; i < 200000; ++i) many += "{\"id\":" + std::to_string(i) + ",\"pad\":\"xxxxxxxxxxxxxxxxxxxx\"}\n";
+    std::istringstream in(many);
+    std::ostringstream out;
+    json::project(in, {"/id"}, out, 4);
+    std::string projected = out.str();
+    assertEqual(projected.substr(projected.size() - 14), std::string("{\"id\":199999}\n"));
+    assertEqual(projected == json::project(many, {"/id"}, 1), true);
+
+    bool threw = false;
+    try {
+        json::project("[1]\n", pointers);
+    } catch (const json::Malformed&) {
+        threw = true;
+    }
+    assertEqual(threw, true);
+}
+
+void schema() {
+    std::string records;
+    for (int i = 0; i < 100000; ++i) {
+        records += "{\"id\":" + std::to_string(i) + ",\"tenant\":\"t" + std::to_string(i % 1000) + "\"";
+        if (i % 4 == 0) records += ",\"tags\":[1.5,null]";
+        records += "}\n";
+    }
+    std::istringstream in(records);
+    json::Schema schema = json::inferSchema(in, 4);
+    assertEqual(schema.records, size_t(100000));
+    assertEqual(schema.fields.at("/id").min, 0.0);
+    assertEqual(schema.fields.at("/id").max, 99999.0);
+    assertEqual(schema.presence("/tags"), 0.25);
+    assertEqual(schema.fields.at("/tags/*").count(json::ValueType::Concrete::Null), size_t(25000));
+    double distinct = schema.fields.at("/tenant").strings.estimate();
+    assertEqual(distinct > 950 && distinct < 1050, true);
+
+    json::Schema single = json::inferSchema(records, 1);
+    std::ostringstream a, b;
+    schema.dump(a);
+    single.dump(b);
+    assertEqual(a.str(), b.str());
+
+    // Numbers beyond a double widen the range rather than reading as zero.
+    json::Schema extremes = json::inferSchema(std::string_view("{\"v\":1e400}\n{\"v\":2}\n{\"v\":1e-400}\n"), 1);
+    assertEqual(extremes.fields.at("/v").min, 0.0);
+    assertEqual(extremes.fields.at("/v").max, std::numeric_limits<double>::infinity());
+    json::Schema negative = json::inferSchema(std::string_view("{\"v\":-1e400}\n{\"v\":2}\n"), 1);
+    assertEqual(negative.fields.at("/v").min, -std::numeric_limits<double>::infinity());
+    assertEqual(negative.fields.at("/v").max, 2.0);
+}
+
+void sortAndGroup() {
+    std::string records;
+    for (int i = 0; i < 5000; ++i) {
+        records += "{\"ts\":" + std::to_string((i * 7919) % 1000) + ",\"seq\":" + std::to_string(i)
+            + ",\"tenant\":\"t" + std::to_string(i % 3) + "\"}\n";
+    }
+    records += "{\"seq\":-1}\n{\"ts\":\"late\"}\n{\"ts\":null}\n";
+
+    // A tiny memory budget forces many spilled runs and a k-way merge, and a
+    // small fan-in several merge passes.
+    for (auto [memory, fanIn] : {std::pair(size_t(4096), size_t(64)), std::pair(size_t(4096), size_t(3)), std::pair(size_t(1) << 30, size_t(64))}) {
+        std::istringstream in(records);
+        std::ostringstream out;
+        json::SortOptions options;
+        options.memory = memory;
+        options.threads = 3;
+        options.fanIn = fanIn;
+        json::sortNdjson(in, out, "/ts", options);
+        std::istringstream lines(out.str());
+        std::string line;
+        std::vector<std::string> sortedLines;
+        while (std::getline(lines, line)) sortedLines.push_back(line);
+        assertEqual(sortedLines.size(), size_t(5003));
+        assertEqual(sortedLines.front(), std::string("{\"seq\":-1}"));
+        assertEqual(sortedLines[1], std::string("{\"ts\":null}"));
+        assertEqual(sortedLines.back(), std::string("{\"ts\":\"late\"}"));
+        // Stable: ts 0 comes from i = 0, 1000, 2000, ... in input order.
+        assertEqual(sortedLines[2], std::string("{\"ts\":0,\"seq\":0,\"tenant\":\"t0\"}"));
+        assertEqual(sortedLines[3], std::string("{\"ts\":0,\"seq\":1000,\"tenant\":\"t1\"}"));
+        assertEqual(sortedLines[5002 - 1].starts_with("{\"ts\":999,"), true);
+    }
+
+    struct Count : json::Aggregator {
+        std::ostringstream out;
+        size_t records = 0;
+        void begin(std::string_view key) override { out << key << "="; records = 0; }
+        void record(std::string_view) override { ++records; }
+        void end() override { out << records << ";"; }
+    } count;
+    std::istringstream in(records);
+    json::SortOptions small;
+    small.memory = 8192;
+    json::groupBy(in, "/tenant", count, small);
+    assertEqual(count.out.str(), std::string("=3;\"t0\"=1667;\"t1\"=1667;\"t2\"=1666;"));
+
+    // Numbers beyond the range of a double sort as infinities or zeros.
+    std::istringstream extremes("{\"v\":1e400}\n{\"v\":-1e400}\n{\"v\":1e-400}\n{\"v\":-5}\n{\"v\":0.5}\n");
+    std::ostringstream ordered;
+    json::sortNdjson(extremes, ordered, "/v");
+    assertEqual(ordered.str(), std::string("{\"v\":-1e400}\n{\"v\":-5}\n{\"v\":1e-400}\n{\"v\":0.5}\n{\"v\":1e400}\n"));
+}
+
+void inSitu() {
+    char buffer[] = "{\"name\": \"J\\u00e9r\\u00f4me \\\"JJ\\\"\", \"tags\": [\"a\\nb\", -1.5e1, 3, null]}";
+    json::Json json = json::parseInSitu(std::span(buffer, sizeof(buffer) - 1));
+    auto name = json::from_json<std::string_view>(json["name"]);
+    assertEqual(name, std::string_view("J\u00e9r\u00f4me \"JJ\""));
+    // The string lives in the buffer, decoded where its escaped form was.
+    assertEqual(name.data() > buffer && name.data() < buffer + sizeof(buffer), true);
+    assertEqual(json["tags"][0].as<std::string>(), std::string("a\nb"));
+    assertEqual(json["tags"][1].as<float>(), -15.0f);
+    std::ostringstream os;
+    os << json;
+    assertEqual(os.str(), std::string("{\"name\":\"J\u00e9r\u00f4me \\\"JJ\\\"\",\"tags\":[\"a\\nb\",-15,3,null]}"));
+
+    for (const char* bad : {"{\"a\" 1}", "[1,]", "\"\\x\"", "01", "[1] 2", "\"\\ud800\""}) {
+        std::string text = bad;
+        bool threw = false;
+        try {
+            json::parseInSitu(text);
+        } catch (const json::Malformed&) {
+            threw = true;
+        }
+        assertEqual(threw, true);
+    }
+}
+
+void padded() {
+    std::string text = "{\"long\": \"" + std::string(100, 'x') + "\\t" + std::string(40, 'y') + "\", \"id\": 12345678901, \"n\": -0.5}";
+    json::PaddedString owned(text);
+    json::Json fromPadded = json::parse(owned);
+    std::ostringstream a, b;
+    a << fromPadded;
+    b << json::parse(text);
+    assertEqual(a.str(), b.str());
+    assertEqual(fromPadded["long"].as<std::string>().size(), size_t(141));
+    assertEqual(fromPadded["n"].as<float>(), -0.5f);
+
+    // Scans stop at the zeroed padding instead of checking bounds.
+    json::PaddedString digits("12345678");
+    assertEqual(json::parse(digits).as<int>(), 12345678);
+    for (std::string bad : {"\"abc", "[1, 2", "{\"a\": tru", "1.", "\"\\u12"}) {
+        json::PaddedString truncated(bad);
+        bool threw = false;
+        try {
+            json::parse(truncated);
+        } catch (const json::Malformed&) {
+            threw = true;
+        }
+        assertEqual(threw, true);
+    }
+
+    char memory[16 + json::padding];
+    std::memcpy(memory, "[\"in\\nsitu\"]", 12);
+    json::Json json = json::parseInSitu(json::PaddedBuffer(std::span(memory), 12));
+    assertEqual(json[0].as<std::string>(), std::string("in\nsitu"));
+}
+
+void kernels() {
+    std::string text;
+    for (int i = 0; i < 4000; ++i) text.push_back(" \t\n\rab\"\\\x01\xc3\xa9{"[(i * 7919 + i / 13) % 13]);
+    json::Isa original = json::activeIsa();
+    std::vector<size_t> expected;
+    for (json::Isa isa : {json::Isa::Scalar, json::Isa::SSE42, json::Isa::AVX2, json::Isa::AVX512}) {
+        if (!json::supported(isa)) continue;
+        json::setIsa(isa);
+        const json::Kernels& k = json::kernels();
+        std::vector<size_t> found;
+        const char* end = text.data() + text.size();
+        for (size_t i = 0; i < text.size(); i += 37) {
+            const char* p = text.data() + i;
+            found.push_back(k.findQuoteOrSpace(p, end) - p);
+            found.push_back(k.findQuoteOrBackslash(p, end) - p);
+            found.push_back(k.findStringSpecial(p, end) - p);
+            found.push_back(k.skipWhitespace(p, end) - p);
+        }
+        if (expected.empty()) expected = found;
+        assertEqual(found == expected, true);
+        assertEqual(json::validUtf8(std::string(100, 'a') + "\xc3\xa9\xf0\x9f\x98\x80" + std::string(100, 'b')), true);
+        assertEqual(json::validUtf8(std::string(100, 'a') + "\xc0\xaf" + std::string(100, 'b')), false);
+        assertEqual(json::validUtf8(std::string(100, 'a') + "\xed\xa0\x80"), false);
+        assertEqual(json::validUtf8(std::string(63, 'a') + "\xe2\x82"), false);
+    }
+    json::setIsa(original);
+
+    bool threw = false;
+    try {
+        json::parse("\"\xff\"");
+    } catch (const json::Malformed&) {
+        threw = true;
+    }
+    assertEqual(threw, true);
+}
+
+void rawNumbers() {
+    std::string text = "{\"big\":9007199254740993,\"e\":1E+2,\"n\":-12,\"pi\":3.141592653589793238}";
+    json::ParseOptions options;
+    options.rawNumbers = true;
+    json::Json json = json::parse(text, options);
+    std::ostringstream os;
+    os << json;
+    assertEqual(os.str(), text);
+    assertEqual(json["big"].number<int64_t>(), int64_t(9007199254740993));
+    assertEqual(json["pi"].number<double>(), 3.141592653589793);
+    assertEqual(json["n"].as<int>(), -12);
+    assertEqual(json["e"].as<float>(), 100.0f);
+    assertEqual(json["e"].number<int>(), 100);
+
+    // Writing a value drops its lexeme.
+    json["n"] = 5;
+    assertEqual(json["n"].get_if<int>().value(), 5);
+
+    // Without the option, numbers are decoded up front and re-formatted.
+    std::ostringstream decoded;
+    decoded << json::parse(text);
+    assertEqual(decoded.str() == text, false);
+
+    // Numbers beyond int and float keep their lexeme even without the option.
+    std::ostringstream wide;
+    json::Json outOfRange = json::parse("[1e400,-2e39,12345678901,2]");
+    wide << outOfRange;
+    assertEqual(wide.str(), std::string("[1e400,-2e39,12345678901,2]"));
+    assertEqual(outOfRange[1].number<double>(), -2e39);
+    assertEqual(outOfRange[2].number<int64_t>(), int64_t(12345678901));
+    // Reads that cannot be represented throw rather than returning 0.
+    int thrown = 0;
+    try { outOfRange[0].as<float>(); } catch (const json::WrongObjectType&) { ++thrown; }
+    try { outOfRange[0].number<double>(); } catch (const json::WrongObjectType&) { ++thrown; }
+    try { outOfRange[2].number<int>(); } catch (const json::WrongObjectType&) { ++thrown; }
+    try { json["pi"].number<int8_t>(); } catch (const json::WrongObjectType&) { thrown += 10; }
+    try { json["big"].number<int>(); } catch (const json::WrongObjectType&) { ++thrown; }
+    assertEqual(thrown, 4);
+
+    char buffer[] = "[1.50, 2]";
+    json::Json inSitu = json::parseInSitu(std::span(buffer, sizeof(buffer) - 1), options);
+    std::ostringstream raw;
+    raw << inSitu;
+    assertEqual(raw.str(), std::string("[1.50,2]"));
+}
+
+void chunkedStrings() {
+    struct Recorder : json::sax::Handler {
+        std::vector<std::string> events;
+        void string(std::string_view value) override { events.push_back("string " + std::string(value)); }
+        void beginString() override { events.push_back("begin"); }
+        void stringChunk(std::string_view piece) override { events.push_back(std::string(piece)); }
+        void endString() override { events.push_back("end"); }
+    };
+    std::string text = "[\"abcdefghijklmnopqrst\", \"short\", \"a\\nbcdefghij\"]";
+    json::sax::Options options{.chunk = 8};
+    Recorder recorder;
+    json::sax::parse(text, recorder, options);
+    assertEqual(recorder.events.size(), size_t(10));
+    assertEqual(recorder.events[1], std::string("abcdefgh"));
+    assertEqual(recorder.events[3], std::string("qrst"));
+    assertEqual(recorder.events[5], std::string("string short"));
+    assertEqual(recorder.events[7], std::string("a\nbcdefg"));
+
+    // Streams split the same way; handlers that ignore chunks get whole strings.
+    struct Whole : json::sax::Handler {
+        std::vector<std::string> strings;
+        void string(std::string_view value) override { strings.emplace_back(value); }
+    };
+    std::string big(200000, 'x');
+    big[150000] = '\t';
+    std::istringstream in("[\"" + big.substr(0, 150000) + "\\t" + big.substr(150001) + "\"]");
+    Whole whole;
+    json::sax::parse(in, whole, json::sax::Options{.chunk = 4096});
+    assertEqual(whole.strings.size(), size_t(1));
+    assertEqual(whole.strings[0] == big, true);
+
+    std::ostringstream written;
+    json::sax::Writer writer(written);
+    json::sax::parse(text, writer, options);
+    assertEqual(written.str(), std::string("[\"abcdefghijklmnopqrst\",\"short\",\"a\\nbcdefghij\"]\n"));
+
+    // Pipeline stages handle strings longer than their pieces.
+    std::string record = "{\"a\":\"" + std::string(100000, 'y') + "\",\"b\":\"" + std::string(100000, 'z') + "\"}";
+    assertEqual(json::Pipeline().redact({"a"}).truncate(3).run(record), std::string("{\"a\":\"***\",\"b\":\"zzz\"}\n"));
+
+    // The DOM can leave long strings in a mapped file.
+    std::ofstream("tests/long.json") << "{\"blob\":\"" << std::string(1000, 'q') << "\",\"s\":\"\\u00e9\"}";
+    json::ParseOptions referenced;
+    referenced.referenceStrings = 64;
+    json::Json json = json::fromFile("tests/long.json", referenced);
+    std::remove("tests/long.json");
+    assertEqual(json["blob"].as<std::string>(), std::string(1000, 'q'));
+    assertEqual(json["s"].as<std::string>(), std::string("\u00e9"));
+    json["blob"] = std::string("replaced");
+    assertEqual(json["blob"].as<std::string>(), std::string("replaced"));
+}
+
+// Torn down at exit, after the main thread's thread_local objects.
+json::Json nestedAtExit = json::parse("[[[1]],[[2]],{\"a\":[[3]]}]");
+
+void reclaim() {
+    // Deep enough to overflow the stack if released recursively.
+    auto root = std::make_shared<json::ListNode>();
+    auto tail = root;
+    for (int i = 0; i < 1000000; ++i) {
+        auto next = std::make_shared<json::ListNode>();
+        tail->addChild(next);
+        auto object = std::make_shared<json::ObjectNode>();
+        object->addOrEditChild("x", std::make_shared<json::ValueNode<int>>(i));
+        tail->addChild(object);
+        tail = next;
+    }
+    tail.reset();
+    root.reset();
+    assertEqual(root == nullptr, true);
+
+    std::string text = "[";
+    for (int i = 0; i < 10000; ++i) text += (i ? "," : "") + std::string("{\"a\":[1,2,{\"b\":\"c\"}]}");
+    text += "]";
+    json::Json document = json::parse(text);
+    json::Json shared = document;
+    json::reclaimInBackground(std::move(document));
+    json::reclaimInBackground(json::parse(text));
+    assertEqual(shared[9999]["a"][2]["b"].as<std::string>(), std::string("c"));
+    assertEqual(nestedAtExit[2]["a"][0][0].as<int>(), 3);
+}
+
+void arena() {
+    std::string text = "[";
+    for (int i = 0; i < 5000; ++i) text += (i ? "," : "") + std::string("{\"id\":") + std::to_string(i) + ",\"tags\":[true,null,\"t\"]}";
+    text += "]";
+
+    auto small = std::make_shared<json::Arena>(json::Arena::Options{.blockSize = 4096});
+    json::Json json = json::parse(text, json::ParseOptions{.arena = small});
+    assertEqual(small->blocksWith(json::Arena::Pages::Normal) > 1, true);
+    assertEqual(json[4999]["id"].as<int>(), 4999);
+
+    // Huge pages fall back to whatever the system grants; the document
+    // outlives every handle to its arena.
+    auto huge = std::make_shared<json::Arena>(json::Arena::Options{.hugePages = true});
+    json = json::parse(text, json::ParseOptions{.arena = huge});
+    size_t blocks = huge->blocksWith(json::Arena::Pages::Normal) + huge->blocksWith(json::Arena::Pages::Transparent)
+        + huge->blocksWith(json::Arena::Pages::Explicit);
+    assertEqual(blocks >= 1, true);
+    assertEqual(huge->capacity() % (size_t(1) << 21), size_t(0));
+    small.reset();
+    huge.reset();
+    assertEqual(json[10]["tags"][2].as<std::string>(), std::string("t"));
+    std::ostringstream os;
+    os << json;
+    assertEqual(os.str(), text);
+}
+
+void smallDocument() {
+    json::resetStats();
+    json::SmallDocument<> message("{\"a\":1,\"list\":[true,\"two\",3.5],\"text\":\"a string too long to be inline\"}");
+    json::Stats stats = json::stats();
+    assertEqual(message.fits(), true);
+    assertEqual(stats.total().allocations, size_t(0));
+    assertEqual((*message)["list"][1].as<std::string>(), std::string("two"));
+    assertEqual(message->get_if<int>().has_value(), false);
+    std::ostringstream os;
+    os << *message;
+    assertEqual(os.str(), std::string("{\"a\":1,\"list\":[true,\"two\",3.5],\"text\":\"a string too long to be inline\"}"));
+
+    // Larger documents spill into heap blocks.
+    std::string text = "[";
+    for (int i = 0; i < 1000; ++i) text += (i ? "," : "") + std::to_string(i);
+    text += "]";
+    json::SmallDocument<256> spilled(text);
+    assertEqual(spilled.fits(), false);
+    assertEqual((*spilled)[999].as<int>(), 999);
+}
+
+void splice() {
+    auto arena = std::make_shared<json::Arena>();
+    json::Json batch = json::parse("{\"tenants\":{\"a\":{\"n\":1},\"b\":[10,20,30]}}", json::ParseOptions{.arena = arena});
+    const json::Node* node = &batch["tenants"]["a"].node();
+    json::Json a = batch.extract("/tenants/a");
+    assertEqual(&a.node() == node, true);
+    assertEqual(a["n"].as<int>(), 1);
+    json::Json twenty = batch.extract("/tenants/b/1");
+    assertEqual(twenty.as<int>(), 20);
+    std::ostringstream os;
+    os << batch;
+    assertEqual(os.str(), std::string("{\"tenants\":{\"b\":[10,30]}}"));
+
+    bool threw = false;
+    try { batch.extract("/tenants/b/5"); } catch (const std::out_of_range&) { threw = true; }
+    assertEqual(threw, true);
+    threw = false;
+    try { batch.extract("/tenants/b/0/x"); } catch (const json::WrongObjectType&) { threw = true; }
+    assertEqual(threw, true);
+
+    // Subtrees move between documents with different allocators.
+    json::Json target = json::parse("{\"x\":null,\"y\":null,\"z\":null}");
+    target["x"].adopt(std::move(a));
+    assertEqual(a.node().isNull(), true);
+    arena.reset();
+    batch = json::parse("null");
+    assertEqual(target["x"]["n"].as<int>(), 1);
+
+    // Nodes from another arena are copied into the heap document, so they
+    // are new nodes with the same value.
+    const json::Node* moved = &twenty.node();
+    target["y"].adopt(std::move(twenty));
+    assertEqual(&target["y"].node() == moved, false);
+    assertEqual(target["y"].as<int>(), 20);
+    // Heap nodes adopted into a heap document are linked in as they are.
+    json::Json heap = json::parse("[7]");
+    moved = &heap.node();
+    target["y"].adopt(std::move(heap));
+    assertEqual(&target["y"].node() == moved, true);
+
+    {
+        json::SmallDocument<> message("{\"list\":[2.5,\"a string too long to be inline\"]}");
+        target["z"].adopt(std::move(*message));
+    }
+    assertEqual(target["z"]["list"][0].as<float>(), 2.5f);
+    assertEqual(target["z"]["list"][1].as<std::string>(), std::string("a string too long to be inline"));
+
+    json::Json copied = json::parse("null");
+    {
+        json::ParseOptions options;
+        options.rawNumbers = true;
+        json::SmallDocument<> message("{\"list\":[1.5,\"s\",true,{}]}", options);
+        copied = message->relocate();
+    }
+    std::ostringstream relocated;
+    relocated << copied;
+    assertEqual(relocated.str(), std::string("{\"list\":[1.5,\"s\",true,{}]}"));
+}
+
+void slices() {
+    json::Json json = json::parse("{\"items\":[0,1,2,3,4,5,6,7,8,9]}");
+    json::Json::Elements page = json["items"].subspan(3, 4);
+    assertEqual(page.size(), size_t(4));
+    std::ostringstream os;
+    page.dump(os);
+    assertEqual(os.str(), std::string("[3,4,5,6]"));
+
+    // Slices share the elements rather than copying them.
+    assertEqual(&(*page.begin()).node() == &json["items"][3].node(), true);
+    int sum = 0;
+    for (auto value : page | std::views::transform([](json::Json::View v) { return v.as<int>(); })) sum += value;
+    assertEqual(sum, 18);
+
+    assertEqual(json["items"].subspan(8).size(), size_t(2));
+    assertEqual(json["items"].slice(7, 100).size(), size_t(3));
+    assertEqual(json["items"].slice(20, 30).size(), size_t(0));
+    std::ostringstream empty;
+    json["items"].slice(5, 2).dump(empty);
+    assertEqual(empty.str(), std::string("[]"));
+
+    json::Json list = json::parse("[\"a\",\"b\",\"c\"]");
+    assertEqual((*list.slice(1, 2).begin()).as<std::string>(), std::string("b"));
+}
+
 int main() {
     get();
+    stats();
+    latency();
+    profile();
+    iterate();
+    keys();
+    checked();
+    convert();
+    minify();
+    pipeline();
+    project();
+    schema();
+    sortAndGroup();
+    inSitu();
+    padded();
+    kernels();
+    rawNumbers();
+    chunkedStrings();
+    reclaim();
+    arena();
+    smallDocument();
+    splice();
+    slices();
     return 0;
 }
\ No newline at end of file
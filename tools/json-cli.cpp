@@ -0,0 +1,299 @@
+// json-cli: command-line front end for the library.
+//
+//     json-cli validate [file]
+//     json-cli minify [file]
+//     json-cli pretty [--indent N] [file]
+//     json-cli query <jsonpath> [file]
+//     json-cli stats [file]
+//     json-cli ndjson-split <lines> <prefix> [file]
+//
+// Without a file (or with "-") input is read from stdin. Every subcommand
+// accepts NDJSON as well as a single document and streams: files are mapped
+// into memory, stdin goes through fixed-size buffers, and no subcommand
+// builds a tree. minify and pretty copy strings byte for byte and do not
+// validate; run validate first when that matters.
+
+#include "json.hpp"
+#include "mapped.hpp"
+#include "profile.hpp"
+#include "sax.hpp"
+#include "stream.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Either a mapped file or stdin.
+class Input {
+private:
+    std::unique_ptr<json::MappedFile> file;
+public:
+    explicit Input(const std::string& path) {
+        if (!path.empty() && path != "-") file = std::make_unique<json::MappedFile>(path);
+    }
+    void parse(json::sax::Handler& handler) {
+        json::sax::Options options{.sequence = true};
+        if (file) json::sax::parse(file->view(), handler, options);
+        else json::sax::parse(std::cin, handler, options);
+    }
+    json::Profile profile() {
+        return file ? json::profile(file->view()) : json::profile(std::cin);
+    }
+    std::optional<std::string_view> mapped() const {
+        if (file) return file->view();
+        return std::nullopt;
+    }
+};
+
+// A JSONPath subset: $, .key, ['key'], [n], [*] and .*
+struct Step {
+    enum Kind { Key, Index, Any } kind;
+    std::string key;
+    size_t index = 0;
+};
+
+std::vector<Step> parsePath(const std::string& path) {
+    std::vector<Step> steps;
+    size_t i = 0;
+    if (i < path.size() && path[i] == '$') ++i;
+    auto invalid = [&] { return std::runtime_error("Invalid path at offset " + std::to_string(i) + "."); };
+    while (i < path.size()) {
+        if (path[i] == '.') {
+            ++i;
+            if (i < path.size() && path[i] == '*') {
+                steps.push_back(Step{Step::Any, {}, 0});
+                ++i;
+                continue;
+            }
+            size_t start = i;
+            while (i < path.size() && path[i] != '.' && path[i] != '[') ++i;
+            if (i == start) throw invalid();
+            steps.push_back(Step{Step::Key, path.substr(start, i - start), 0});
+        } else if (path[i] == '[') {
+            ++i;
+            if (i < path.size() && path[i] == '*') {
+                steps.push_back(Step{Step::Any, {}, 0});
+                ++i;
+            } else if (i < path.size() && (path[i] == '\'' || path[i] == '"')) {
+                char quote = path[i++];
+                size_t end = path.find(quote, i);
+                if (end == std::string::npos) throw invalid();
+                steps.push_back(Step{Step::Key, path.substr(i, end - i), 0});
+                i = end + 1;
+            } else {
+                size_t start = i;
+                while (i < path.size() && std::isdigit(static_cast<unsigned char>(path[i]))) ++i;
+                if (i == start) throw invalid();
+                steps.push_back(Step{Step::Index, {}, std::stoul(path.substr(start, i - start))});
+            }
+            if (i >= path.size() || path[i] != ']') throw invalid();
+            ++i;
+        } else {
+            throw invalid();
+        }
+    }
+    return steps;
+}
+
+// Writes every value whose path matches the query, one per line. Only the
+// containers on the way to a match are tracked.
+class Query : public json::sax::Handler {
+private:
+    struct Frame {
+        bool object;
+        // Whether the path to this container is a prefix of the query.
+        bool live;
+        size_t index;
+        std::string key;
+    };
+    std::vector<Step> steps;
+    std::vector<Frame> frames;
+    json::sax::Writer writer;
+    // Depth inside the match being written, 0 when not writing.
+    size_t capturing = 0;
+
+    bool stepMatches(const Step& step, const Frame& frame) const {
+        switch (step.kind) {
+            case Step::Any:
+                return true;
+            case Step::Key:
+                return frame.object && frame.key == step.key;
+            default:
+                return !frame.object && frame.index == step.index;
+        }
+    }
+    // Called at the start of every value outside a match.
+    bool startValue() {
+        if (frames.empty()) return steps.empty();
+        Frame& top = frames.back();
+        bool match = top.live && frames.size() == steps.size() && stepMatches(steps[frames.size() - 1], top);
+        return match;
+    }
+    void finishValue() {
+        if (!frames.empty() && !frames.back().object) ++frames.back().index;
+    }
+    void scalar(auto write) {
+        if (capturing) {
+            write();
+            return;
+        }
+        if (startValue()) {
+            write();
+            writer.endDocument();
+        }
+        finishValue();
+    }
+    void begin(bool object) {
+        if (capturing) {
+            ++capturing;
+        } else if (startValue()) {
+            capturing = 1;
+        } else {
+            bool live = frames.empty()
+                || (frames.back().live && frames.size() < steps.size() && stepMatches(steps[frames.size() - 1], frames.back()));
+            frames.push_back(Frame{object, live, 0, {}});
+            return;
+        }
+        if (object) writer.beginObject();
+        else writer.beginList();
+    }
+    void end(bool object) {
+        if (!capturing) {
+            frames.pop_back();
+            finishValue();
+            return;
+        }
+        if (object) writer.endObject();
+        else writer.endList();
+        if (--capturing == 0) {
+            writer.endDocument();
+            finishValue();
+        }
+    }
+public:
+    Query(std::vector<Step> steps, std::ostream& os) : steps(std::move(steps)), writer(os) { }
+    void null() override { scalar([&] { writer.null(); }); }
+    void boolean(bool value) override { scalar([&] { writer.boolean(value); }); }
+    void number(std::string_view lexeme) override { scalar([&] { writer.number(lexeme); }); }
+    void string(std::string_view value) override { scalar([&] { writer.string(value); }); }
+    void key(std::string_view key) override {
+        if (capturing) writer.key(key);
+        else frames.back().key = key;
+    }
+    void beginObject() override { begin(true); }
+    void endObject() override { end(true); }
+    void beginList() override { begin(false); }
+    void endList() override { end(false); }
+};
+
+int split(Input& input, size_t lines, const std::string& prefix) {
+    if (lines == 0) throw std::runtime_error("Lines per file must be positive.");
+    size_t file = 0;
+    size_t written = lines;
+    std::ofstream out;
+    auto write = [&](std::string_view line) {
+        if (line.empty()) return;
+        if (written == lines) {
+            std::ostringstream name;
+            name << prefix << std::setw(5) << std::setfill('0') << file++ << ".ndjson";
+            out.close();
+            out.open(name.str(), std::ios::binary);
+            if (!out) throw std::runtime_error("Cannot create " + name.str() + ".");
+            written = 0;
+        }
+        out.write(line.data(), line.size());
+        out.put('\n');
+        ++written;
+    };
+    if (auto data = input.mapped()) {
+        while (!data->empty()) {
+            auto newline = static_cast<const char*>(std::memchr(data->data(), '\n', data->size()));
+            size_t length = newline ? newline - data->data() : data->size();
+            write(data->substr(0, length));
+            data->remove_prefix(newline ? length + 1 : length);
+        }
+    } else {
+        std::string line;
+        while (std::getline(std::cin, line)) write(line);
+    }
+    return 0;
+}
+
+int usage() {
+    std::cerr << "usage: json-cli validate [file]\n"
+              << "       json-cli minify [file]\n"
+              << "       json-cli pretty [--indent N] [file]\n"
+              << "       json-cli query <jsonpath> [file]\n"
+              << "       json-cli stats [file]\n"
+              << "       json-cli ndjson-split <lines> <prefix> [file]\n";
+    return 2;
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (args.empty()) return usage();
+    std::string command = args[0];
+    args.erase(args.begin());
+    auto file = [&](size_t i) { return i < args.size() ? args[i] : std::string(); };
+
+    try {
+        if (command == "validate" && args.size() <= 1) {
+            Input input(file(0));
+            json::sax::Handler ignore;
+            input.parse(ignore);
+            return 0;
+        }
+        if (command == "minify" && args.size() <= 1) {
+            Input input(file(0));
+            if (auto data = input.mapped()) json::minify(*data, std::cout);
+            else json::minify(std::cin, std::cout);
+            return 0;
+        }
+        if (command == "pretty") {
+            int indent = 2;
+            if (!args.empty() && args[0] == "--indent" && args.size() >= 2) {
+                indent = std::stoi(args[1]);
+                args.erase(args.begin(), args.begin() + 2);
+            }
+            if (args.size() > 1) return usage();
+            Input input(file(0));
+            if (auto data = input.mapped()) json::reformat(*data, std::cout, indent);
+            else json::reformat(std::cin, std::cout, indent);
+            return 0;
+        }
+        if (command == "query" && !args.empty() && args.size() <= 2) {
+            Query query(parsePath(args[0]), std::cout);
+            Input input(file(1));
+            input.parse(query);
+            return 0;
+        }
+        if (command == "stats" && args.size() <= 1) {
+            Input input(file(0));
+            input.profile().dump(std::cout) << "\n";
+            return 0;
+        }
+        if (command == "ndjson-split" && args.size() >= 2 && args.size() <= 3) {
+            Input input(file(2));
+            return split(input, std::stoul(args[0]), args[1]);
+        }
+    } catch (const json::Malformed& e) {
+        std::cerr << "json-cli: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "json-cli: " << e.what() << "\n";
+        return 1;
+    }
+    return usage();
+}
@@ -0,0 +1,675 @@
+// jsongen: generates C++ structs with specialised parse and serialize
+// functions from a sample document or a JSON Schema.
+//
+//     jsongen [--schema] [--name Root] [--namespace ns] input.json > out.hpp
+//
+// The generated header has no dependency on this library. Objects become
+// structs with one member per field; keys are dispatched with a switch on
+// their length followed by memcmp, and unknown keys are skipped without
+// building anything. Fields whose type varies across the input are kept as
+// raw JSON text; fields seen as null, or declared nullable, are optional.
+
+#include "json.hpp"
+#include "sax.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+enum class Kind {
+    Unknown, Null, Bool, Int, Float, String, Object, List, Any
+};
+
+// A parsed input document, keeping only what type inference needs.
+struct Sample {
+    Kind kind;
+    std::string text;
+    std::vector<std::pair<std::string, Sample>> members;
+};
+
+class SampleBuilder : public json::sax::Handler {
+private:
+    std::vector<Sample*> stack;
+    std::string pendingKey;
+    Sample& add(Kind kind) {
+        if (stack.empty()) return documents.emplace_back(Sample{kind, {}, {}});
+        stack.back()->members.emplace_back(std::move(pendingKey), Sample{kind, {}, {}});
+        return stack.back()->members.back().second;
+    }
+public:
+    std::vector<Sample> documents;
+    void null() override { add(Kind::Null); }
+    void boolean(bool) override { add(Kind::Bool); }
+    void number(std::string_view lexeme) override {
+        add(lexeme.find_first_of(".eE") == std::string_view::npos ? Kind::Int : Kind::Float);
+    }
+    void string(std::string_view value) override { add(Kind::String).text = value; }
+    void key(std::string_view key) override { pendingKey = key; }
+    void beginObject() override { stack.push_back(&add(Kind::Object)); }
+    void endObject() override { stack.pop_back(); }
+    void beginList() override { stack.push_back(&add(Kind::List)); }
+    void endList() override { stack.pop_back(); }
+};
+
+struct Type {
+    Kind kind = Kind::Unknown;
+    std::vector<std::pair<std::string, Type>> fields;
+    // One element type for lists, empty otherwise.
+    std::vector<Type> element;
+    std::string name;
+    // The C++ names of the fields, in the same order.
+    std::vector<std::string> members;
+    // Also seen as null.
+    bool nullable = false;
+};
+
+void merge(Type& into, const Type& from) {
+    bool nullable = into.nullable || from.nullable || into.kind == Kind::Null || from.kind == Kind::Null;
+    if (from.kind == Kind::Unknown || from.kind == Kind::Null) {
+        if (into.kind == Kind::Unknown) into = from;
+        into.nullable = nullable;
+        return;
+    }
+    if (into.kind == Kind::Unknown || into.kind == Kind::Null) {
+        into = from;
+        into.nullable = nullable;
+        return;
+    }
+    into.nullable = nullable;
+    bool numbers = (into.kind == Kind::Int || into.kind == Kind::Float)
+        && (from.kind == Kind::Int || from.kind == Kind::Float);
+    if (numbers) {
+        if (from.kind == Kind::Float) into.kind = Kind::Float;
+        return;
+    }
+    if (into.kind != from.kind) {
+        into = Type{Kind::Any, {}, {}, {}};
+        return;
+    }
+    if (into.kind == Kind::Object) {
+        for (auto& [key, type] : from.fields) {
+            auto it = into.fields.begin();
+            while (it != into.fields.end() && it->first != key) ++it;
+            if (it == into.fields.end()) into.fields.emplace_back(key, type);
+            else merge(it->second, type);
+        }
+    } else if (into.kind == Kind::List) {
+        if (into.element.empty()) into.element = from.element;
+        else if (!from.element.empty()) merge(into.element[0], from.element[0]);
+    }
+}
+
+Type infer(const Sample& sample) {
+    Type type{sample.kind, {}, {}, {}};
+    if (sample.kind == Kind::Object) {
+        Type fields{Kind::Object, {}, {}, {}};
+        for (auto& [key, member] : sample.members) {
+            Type single{Kind::Object, {}, {}, {}};
+            single.fields.emplace_back(key, infer(member));
+            merge(fields, single);
+        }
+        return fields;
+    }
+    if (sample.kind == Kind::List && !sample.members.empty()) {
+        type.element.push_back(Type{});
+        for (auto& [key, member] : sample.members) merge(type.element[0], infer(member));
+    }
+    return type;
+}
+
+const Sample* member(const Sample& sample, std::string_view key) {
+    if (sample.kind != Kind::Object) return nullptr;
+    for (auto& [name, value] : sample.members) {
+        if (name == key) return &value;
+    }
+    return nullptr;
+}
+
+Type fromSchema(const Sample& schema);
+
+Type fromSchemaType(const Sample& schema, const std::string& name) {
+    if (name == "object") {
+        Type object{Kind::Object, {}, {}, {}};
+        if (auto properties = member(schema, "properties")) {
+            for (auto& [key, property] : properties->members) object.fields.emplace_back(key, fromSchema(property));
+        }
+        return object;
+    }
+    if (name == "array") {
+        Type list{Kind::List, {}, {}, {}};
+        if (auto items = member(schema, "items")) list.element.push_back(fromSchema(*items));
+        return list;
+    }
+    if (name == "string") return Type{Kind::String, {}, {}, {}};
+    if (name == "integer") return Type{Kind::Int, {}, {}, {}};
+    if (name == "number") return Type{Kind::Float, {}, {}, {}};
+    if (name == "boolean") return Type{Kind::Bool, {}, {}, {}};
+    return Type{Kind::Any, {}, {}, {}};
+}
+
+Type fromSchema(const Sample& schema) {
+    std::string name;
+    bool nullable = false;
+    if (auto type = member(schema, "type")) {
+        if (type->kind == Kind::String) {
+            name = type->text;
+        } else if (type->kind == Kind::List) {
+            // ["string", "null"] and the like: the first non-null type wins
+            // and null makes it optional.
+            for (auto& [key, alternative] : type->members) {
+                if (alternative.kind != Kind::String) continue;
+                if (alternative.text == "null") nullable = true;
+                else if (name.empty()) name = alternative.text;
+            }
+        }
+    }
+    Type type = fromSchemaType(schema, name);
+    type.nullable = nullable;
+    return type;
+}
+
+std::string identifier(std::string_view key, bool type) {
+    static const std::set<std::string, std::less<>> reserved = {
+        "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break",
+        "case", "catch", "char", "char8_t", "char16_t", "char32_t", "class", "compl", "concept",
+        "const", "consteval", "constexpr", "constinit", "const_cast", "continue", "co_await",
+        "co_return", "co_yield", "decltype", "default", "delete", "do", "double", "dynamic_cast",
+        "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend", "goto",
+        "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+        "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register",
+        "reinterpret_cast", "requires", "return", "short", "signed", "sizeof", "static",
+        "static_assert", "static_cast", "struct", "switch", "template", "this", "thread_local",
+        "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using",
+        "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq",
+    };
+    std::string id;
+    bool upper = type;
+    for (char ch : key) {
+        bool alnum = ('a' <= ch && ch <= 'z') || ('A' <= ch && ch <= 'Z') || ('0' <= ch && ch <= '9');
+        if (!alnum) {
+            if (type) upper = true;
+            else id.push_back('_');
+            continue;
+        }
+        id.push_back(upper && 'a' <= ch && ch <= 'z' ? static_cast<char>(ch - 'a' + 'A') : ch);
+        upper = false;
+    }
+    if (id.empty() || ('0' <= id[0] && id[0] <= '9')) id.insert(0, "_");
+    if (reserved.contains(id)) id.push_back('_');
+    return id;
+}
+
+void nameStructs(Type& type, const std::string& hint, std::set<std::string>& used) {
+    if (type.kind == Kind::Object) {
+        std::string base = identifier(hint, true);
+        type.name = base;
+        for (int i = 2; used.contains(type.name); ++i) type.name = base + std::to_string(i);
+        used.insert(type.name);
+        for (auto& [key, field] : type.fields) nameStructs(field, key, used);
+    } else if (type.kind == Kind::List && !type.element.empty()) {
+        nameStructs(type.element[0], hint + "Item", used);
+    }
+}
+
+// Members may not repeat within a struct, nor shadow the types its later
+// members are declared with.
+void nameMembers(Type& type, const std::set<std::string>& types) {
+    if (type.kind == Kind::Object) {
+        std::set<std::string> used = types;
+        used.insert("int64_t");
+        for (auto& [key, field] : type.fields) {
+            std::string base = identifier(key, false);
+            std::string member = base;
+            for (int i = 2; used.contains(member); ++i) member = base + std::to_string(i);
+            used.insert(member);
+            type.members.push_back(member);
+            nameMembers(field, types);
+        }
+    } else if (type.kind == Kind::List && !type.element.empty()) {
+        nameMembers(type.element[0], types);
+    }
+}
+
+std::string cppType(const Type& type);
+
+// Raw already holds null.
+bool optional(const Type& type) {
+    return type.nullable && type.kind != Kind::Null && type.kind != Kind::Any && type.kind != Kind::Unknown;
+}
+
+std::string valueType(const Type& type) {
+    switch (type.kind) {
+        case Kind::Bool:
+            return "bool";
+        case Kind::Int:
+            return "int64_t";
+        case Kind::Float:
+            return "double";
+        case Kind::String:
+            return "std::string";
+        case Kind::Object:
+            return type.name;
+        case Kind::List:
+            return "std::vector<" + (type.element.empty() ? std::string("Raw") : cppType(type.element[0])) + ">";
+        default:
+            return "Raw";
+    }
+}
+
+std::string cppType(const Type& type) {
+    if (optional(type)) return "std::optional<" + valueType(type) + ">";
+    return valueType(type);
+}
+
+// The key as it appears between the quotes on the wire.
+std::string wire(std::string_view key) {
+    std::ostringstream escaped;
+    json::writeEscaped(escaped, key);
+    std::string str = escaped.str();
+    return str.substr(1, str.size() - 2);
+}
+
+// Arbitrary bytes as a C++ string literal.
+std::string literal(std::string_view bytes) {
+    std::string out = "\"";
+    for (unsigned char ch : bytes) {
+        if (ch == '"' || ch == '\\') {
+            out.push_back('\\');
+            out.push_back(static_cast<char>(ch));
+        } else if (ch < 0x20 || ch >= 0x7F) {
+            static constexpr char octal[] = "01234567";
+            out += {'\\', octal[ch >> 6], octal[(ch >> 3) & 7], octal[ch & 7]};
+        } else {
+            out.push_back(static_cast<char>(ch));
+        }
+    }
+    return out + "\"";
+}
+
+void collect(const Type& type, std::vector<const Type*>& structs) {
+    if (type.kind == Kind::Object) {
+        for (auto& [key, field] : type.fields) collect(field, structs);
+        structs.push_back(&type);
+    } else if (type.kind == Kind::List && !type.element.empty()) {
+        collect(type.element[0], structs);
+    }
+}
+
+void emitStruct(std::ostream& os, const Type& type) {
+    os << "struct " << type.name << " {\n";
+    for (size_t i = 0; i < type.fields.size(); ++i) {
+        os << "    " << cppType(type.fields[i].second) << " " << type.members[i] << "{};\n";
+    }
+    os << "};\n\n";
+}
+
+void emitReader(std::ostream& os, const Type& type) {
+    // Field indices by the length of their key as written.
+    std::map<size_t, std::vector<size_t>> byLength;
+    for (size_t i = 0; i < type.fields.size(); ++i) byLength[wire(type.fields[i].first).size()].push_back(i);
+    os << "inline const char* read(const char* p, const char* end, " << type.name << "& out) {\n"
+       << "    return readObject(p, end, [&](std::string_view key, const char* p) -> const char* {\n"
+       << "        switch (key.size()) {\n";
+    for (auto& [length, fields] : byLength) {
+        os << "            case " << length << ":\n";
+        for (size_t i : fields) {
+            os << "                if (std::memcmp(key.data(), " << literal(wire(type.fields[i].first)) << ", " << length << ") == 0)\n"
+               << "                    return read(p, end, out." << type.members[i] << ");\n";
+        }
+        os << "                break;\n";
+    }
+    os << "        }\n"
+       << "        return skipValue(p, end);\n"
+       << "    });\n"
+       << "}\n\n";
+}
+
+void emitWriter(std::ostream& os, const Type& type) {
+    os << "inline void write(std::ostream& os, const " << type.name << "& in) {\n";
+    bool first = true;
+    for (size_t i = 0; i < type.fields.size(); ++i) {
+        std::string prefix = (first ? "{\"" : ",\"") + wire(type.fields[i].first) + "\":";
+        os << "    os.write(" << literal(prefix) << ", " << prefix.size() << ");\n"
+           << "    write(os, in." << type.members[i] << ");\n";
+        first = false;
+    }
+    if (first) os << "    os.put('{');\n";
+    os << "    os.put('}');\n}\n\n";
+}
+
+constexpr const char* runtime = R"(struct Raw {
+    std::string json;
+};
+
+[[noreturn]] inline void fail() {
+    throw std::runtime_error("Malformed json.");
+}
+
+inline const char* skipWhitespace(const char* p, const char* end) {
+    while (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+    return p;
+}
+
+inline const char* expect(const char* p, const char* end, char ch) {
+    p = skipWhitespace(p, end);
+    if (p == end || *p != ch) fail();
+    return p + 1;
+}
+
+inline const char* skipString(const char* p, const char* end) {
+    for (++p; p != end; ++p) {
+        if (*p == '\\') ++p;
+        else if (*p == '"') return p + 1;
+        if (p == end) break;
+    }
+    fail();
+}
+
+inline const char* skipValue(const char* p, const char* end) {
+    p = skipWhitespace(p, end);
+    if (p == end) fail();
+    if (*p == '"') return skipString(p, end);
+    if (*p != '{' && *p != '[') {
+        while (p != end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t') ++p;
+        return p;
+    }
+    size_t depth = 0;
+    while (p != end) {
+        if (*p == '"') {
+            p = skipString(p, end);
+            continue;
+        }
+        if (*p == '{' || *p == '[') ++depth;
+        else if ((*p == '}' || *p == ']') && --depth == 0) return p + 1;
+        ++p;
+    }
+    fail();
+}
+
+template <typename Field>
+const char* readObject(const char* p, const char* end, Field field) {
+    p = expect(p, end, '{');
+    p = skipWhitespace(p, end);
+    if (p != end && *p == '}') return p + 1;
+    for (;;) {
+        p = expect(p, end, '"');
+        const char* key = p;
+        while (p != end && *p != '"') p += *p == '\\' ? 2 : 1;
+        if (p >= end) fail();
+        std::string_view name(key, p - key);
+        p = expect(p + 1, end, ':');
+        p = field(name, p);
+        p = skipWhitespace(p, end);
+        if (p == end) fail();
+        if (*p == '}') return p + 1;
+        if (*p++ != ',') fail();
+    }
+}
+
+inline void appendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+inline uint32_t readHex4(const char*& p, const char* end) {
+    if (end - p < 4) fail();
+    uint32_t cp = 0;
+    if (std::from_chars(p, p + 4, cp, 16).ptr != p + 4) fail();
+    p += 4;
+    return cp;
+}
+
+inline const char* read(const char* p, const char* end, std::string& out) {
+    p = expect(p, end, '"');
+    out.clear();
+    for (;;) {
+        const char* start = p;
+        while (p != end && *p != '"' && *p != '\\') ++p;
+        out.append(start, p);
+        if (p == end) fail();
+        if (*p++ == '"') return p;
+        if (p == end) fail();
+        switch (*p++) {
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u': {
+                uint32_t cp = readHex4(p, end);
+                if (0xD800 <= cp && cp < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                    p += 2;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (readHex4(p, end) - 0xDC00);
+                }
+                appendUtf8(out, cp);
+                break;
+            }
+            default: out.push_back(p[-1]);
+        }
+    }
+}
+
+inline const char* read(const char* p, const char* end, int64_t& out) {
+    p = skipWhitespace(p, end);
+    auto [next, error] = std::from_chars(p, end, out);
+    if (error != std::errc() || (next != end && (*next == '.' || *next == 'e' || *next == 'E'))) fail();
+    return next;
+}
+
+inline const char* read(const char* p, const char* end, double& out) {
+    p = skipWhitespace(p, end);
+    auto [next, error] = std::from_chars(p, end, out);
+    if (error != std::errc()) fail();
+    return next;
+}
+
+inline const char* read(const char* p, const char* end, bool& out) {
+    p = skipWhitespace(p, end);
+    if (end - p >= 4 && std::memcmp(p, "true", 4) == 0) {
+        out = true;
+        return p + 4;
+    }
+    if (end - p >= 5 && std::memcmp(p, "false", 5) == 0) {
+        out = false;
+        return p + 5;
+    }
+    fail();
+}
+
+inline const char* read(const char* p, const char* end, Raw& out) {
+    p = skipWhitespace(p, end);
+    const char* next = skipValue(p, end);
+    out.json.assign(p, next);
+    return next;
+}
+
+template <typename T>
+const char* read(const char* p, const char* end, std::vector<T>& out);
+template <typename T>
+const char* read(const char* p, const char* end, std::optional<T>& out);
+template <typename T>
+void write(std::ostream& os, const std::vector<T>& in);
+template <typename T>
+void write(std::ostream& os, const std::optional<T>& in);
+
+template <typename T>
+const char* read(const char* p, const char* end, std::vector<T>& out) {
+    p = expect(p, end, '[');
+    out.clear();
+    p = skipWhitespace(p, end);
+    if (p != end && *p == ']') return p + 1;
+    for (;;) {
+        p = read(p, end, out.emplace_back());
+        p = skipWhitespace(p, end);
+        if (p == end) fail();
+        if (*p == ']') return p + 1;
+        if (*p++ != ',') fail();
+    }
+}
+
+inline void write(std::ostream& os, const std::string& in) {
+    static constexpr char hex[] = "0123456789abcdef";
+    os.put('"');
+    for (unsigned char ch : in) {
+        if (ch == '"' || ch == '\\') {
+            os.put('\\');
+            os.put(static_cast<char>(ch));
+        } else if (ch < 0x20) {
+            os << "\\u00" << hex[ch >> 4] << hex[ch & 15];
+        } else {
+            os.put(static_cast<char>(ch));
+        }
+    }
+    os.put('"');
+}
+
+inline void write(std::ostream& os, int64_t in) {
+    char buffer[24];
+    os.write(buffer, std::to_chars(buffer, buffer + sizeof(buffer), in).ptr - buffer);
+}
+
+inline void write(std::ostream& os, double in) {
+    char buffer[32];
+    os.write(buffer, std::to_chars(buffer, buffer + sizeof(buffer), in).ptr - buffer);
+}
+
+inline void write(std::ostream& os, bool in) {
+    if (in) os.write("true", 4);
+    else os.write("false", 5);
+}
+
+inline void write(std::ostream& os, const Raw& in) {
+    if (in.json.empty()) os.write("null", 4);
+    else os << in.json;
+}
+
+template <typename T>
+const char* read(const char* p, const char* end, std::optional<T>& out) {
+    p = skipWhitespace(p, end);
+    if (end - p >= 4 && std::memcmp(p, "null", 4) == 0) {
+        out.reset();
+        return p + 4;
+    }
+    return read(p, end, out.emplace());
+}
+
+template <typename T>
+void write(std::ostream& os, const std::vector<T>& in) {
+    os.put('[');
+    for (size_t i = 0; i < in.size(); ++i) {
+        if (i) os.put(',');
+        write(os, in[i]);
+    }
+    os.put(']');
+}
+
+template <typename T>
+void write(std::ostream& os, const std::optional<T>& in) {
+    if (in) write(os, *in);
+    else os.write("null", 4);
+}
+
+)";
+
+void generate(std::ostream& os, const Type& root, const std::string& space, const std::string& source) {
+    std::vector<const Type*> structs;
+    collect(root, structs);
+
+    os << "// Generated by jsongen from " << source << ". Do not edit.\n\n"
+       << "#pragma once\n\n"
+       << "#include <charconv>\n#include <cstdint>\n#include <cstring>\n#include <ostream>\n"
+       << "#include <optional>\n#include <stdexcept>\n#include <string>\n#include <string_view>\n#include <vector>\n\n"
+       << "namespace " << space << " {\n\n"
+       << runtime;
+    for (auto type : structs) emitStruct(os, *type);
+    for (auto type : structs) {
+        os << "inline const char* read(const char* p, const char* end, " << type->name << "& out);\n"
+           << "inline void write(std::ostream& os, const " << type->name << "& in);\n";
+    }
+    os << "\n";
+    for (auto type : structs) {
+        emitReader(os, *type);
+        emitWriter(os, *type);
+    }
+    std::string name = cppType(root);
+    os << "inline " << name << " parse(std::string_view json) {\n"
+       << "    " << name << " out{};\n"
+       << "    const char* end = json.data() + json.size();\n"
+       << "    if (skipWhitespace(read(json.data(), end, out), end) != end) fail();\n"
+       << "    return out;\n"
+       << "}\n\n"
+       << "inline std::ostream& serialize(std::ostream& os, const " << name << "& in) {\n"
+       << "    write(os, in);\n"
+       << "    return os;\n"
+       << "}\n\n"
+       << "}\n";
+}
+
+int usage() {
+    std::cerr << "usage: jsongen [--schema] [--name Root] [--namespace ns] input.json\n";
+    return 2;
+}
+
+}
+
+int main(int argc, char** argv) {
+    bool schema = false;
+    std::string name = "Root";
+    std::string space = "generated";
+    std::string input;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--schema") schema = true;
+        else if (arg == "--name" && i + 1 < argc) name = argv[++i];
+        else if (arg == "--namespace" && i + 1 < argc) space = argv[++i];
+        else if (input.empty() && arg[0] != '-') input = arg;
+        else return usage();
+    }
+    if (input.empty()) return usage();
+
+    std::ifstream file(input);
+    if (!file.is_open()) {
+        std::cerr << "jsongen: cannot open " << input << "\n";
+        return 1;
+    }
+    SampleBuilder builder;
+    try {
+        // A sample may be NDJSON; every record refines the inferred types.
+        json::sax::parse(file, builder, json::sax::Options{.sequence = !schema});
+    } catch (const json::Malformed& e) {
+        std::cerr << "jsongen: " << input << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    Type root;
+    for (auto& document : builder.documents) {
+        if (schema) root = fromSchema(document);
+        else merge(root, infer(document));
+    }
+    // The runtime's own types are taken.
+    std::set<std::string> used = {"Raw"};
+    nameStructs(root, name, used);
+    nameMembers(root, used);
+    generate(std::cout, root, space, input);
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "trace.hpp"
+
+#include <bit>
+
+namespace json {
+
+namespace {
+
+std::array<Histogram, operationCount> histograms;
+std::atomic<TraceHook> traceHook{nullptr};
+
+}
+
+std::size_t Histogram::bucketOf(uint64_t value) {
+    if (value < 32) return value;
+    int msb = std::bit_width(value) - 1;
+    int shift = msb - 4;
+    return 32 + (msb - 5) * 16 + ((value >> shift) & 15);
+}
+
+uint64_t Histogram::lowestOf(std::size_t bucket) {
+    if (bucket < 32) return bucket;
+    int msb = (bucket - 32) / 16 + 5;
+    return (16 + (bucket - 32) % 16) << (msb - 4);
+}
+
+uint64_t Histogram::highestOf(std::size_t bucket) {
+    if (bucket < 32) return bucket;
+    int msb = (bucket - 32) / 16 + 5;
+    return lowestOf(bucket) + (uint64_t(1) << (msb - 4)) - 1;
+}
+
+void Histogram::record(uint64_t value) {
+    buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    uint64_t seen = max_.load(std::memory_order_relaxed);
+    while (seen < value && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) { }
+}
+
+void Histogram::reset() {
+    for (auto& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::count() const {
+    return total.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::max() const {
+    return max_.load(std::memory_order_relaxed);
+}
+
+double Histogram::mean() const {
+    uint64_t n = count();
+    return n ? static_cast<double>(sum.load(std::memory_order_relaxed)) / n : 0;
+}
+
+uint64_t Histogram::percentile(double p) const {
+    uint64_t n = count();
+    if (n == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(p / 100 * n + 0.5);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucketCount; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) return std::min(highestOf(i), max());
+    }
+    return max();
+}
+
+const Histogram& latency(Operation op) {
+    return histograms[static_cast<std::size_t>(op)];
+}
+
+void resetLatency() {
+    for (auto& histogram : histograms) histogram.reset();
+}
+
+void setTraceHook(TraceHook hook) {
+    traceHook.store(hook, std::memory_order_release);
+}
+
+#ifdef JSON_TRACE
+TraceScope::TraceScope(Operation op, std::size_t bytes) : op(op), bytes_(bytes) {
+    if (auto hook = traceHook.load(std::memory_order_acquire)) hook(TraceEvent{op, true, bytes_});
+    start = std::chrono::steady_clock::now();
+}
+
+TraceScope::~TraceScope() {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    histograms[static_cast<std::size_t>(op)].record(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    if (auto hook = traceHook.load(std::memory_order_acquire)) hook(TraceEvent{op, false, bytes_});
+}
+#endif
+
+}; // namespace json
@@ -0,0 +1,97 @@
+#ifndef JSON_TRACE_HPP
+#define JSON_TRACE_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace json {
+
+// Latency histograms and trace events are only recorded when the library is
+// built with -DJSON_TRACE. Otherwise TraceScope is empty and costs nothing.
+enum class Operation {
+    Parse, FromFile, Dump, Lookup
+};
+
+constexpr std::size_t operationCount = 4;
+
+constexpr std::string operationName(Operation op) {
+    switch (op) {
+        case Operation::Parse:
+            return "parse";
+        case Operation::FromFile:
+            return "fromFile";
+        case Operation::Dump:
+            return "dump";
+        default:
+            return "lookup";
+    }
+}
+
+// Log-linear histogram in the style of HdrHistogram: values below 32 are
+// exact, larger ones fall in one of 16 sub-buckets per power of two, which
+// bounds the relative error to 1/16. Recording is lock-free.
+class Histogram {
+public:
+    static constexpr std::size_t bucketCount = 32 + 59 * 16;
+private:
+    std::array<std::atomic<uint64_t>, bucketCount> buckets{};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max_{0};
+public:
+    static std::size_t bucketOf(uint64_t value);
+    static uint64_t lowestOf(std::size_t bucket);
+    static uint64_t highestOf(std::size_t bucket);
+
+    void record(uint64_t value);
+    void reset();
+    uint64_t count() const;
+    uint64_t max() const;
+    double mean() const;
+    // Upper bound of the bucket holding the p-th percentile, p in [0, 100].
+    uint64_t percentile(double p) const;
+};
+
+struct TraceEvent {
+    Operation op;
+    bool begin;
+    // Input size for parses, output size for dumps (end events only), 0 for lookups.
+    std::size_t bytes;
+};
+
+typedef void (*TraceHook)(const TraceEvent& event);
+
+// Latencies in nanoseconds, aggregated over all threads.
+const Histogram& latency(Operation op);
+void resetLatency();
+// Pass nullptr to remove the hook.
+void setTraceHook(TraceHook hook);
+
+#ifdef JSON_TRACE
+class TraceScope {
+private:
+    Operation op;
+    std::size_t bytes_;
+    std::chrono::steady_clock::time_point start;
+public:
+    TraceScope(Operation op, std::size_t bytes = 0);
+    ~TraceScope();
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+    void bytes(std::size_t bytes) { bytes_ = bytes; }
+};
+#else
+class TraceScope {
+public:
+    TraceScope(Operation, std::size_t = 0) { }
+    void bytes(std::size_t) { }
+};
+#endif
+
+};
+
+#endif